@@ -0,0 +1,325 @@
+
+
+#include "MazeGenerators.h"
+#include "MazeGraph.h"
+
+#include <random>
+
+
+
+namespace
+{
+	void SetWalkable(TileMap& tileMap, const u32 x, const u32 y, const bool isWalkable)
+	{
+		tileMap.walkable[(size_t)y * tileMap.width + x] = isWalkable ? 1U : 0U;
+	}
+
+	TileMap MakeTileMap(const u32 width, const u32 height, const bool isWalkable)
+	{
+		TileMap tileMap{};
+		tileMap.width = width;
+		tileMap.height = height;
+		tileMap.walkable.assign((size_t)width * height, isWalkable ? 1U : 0U);
+		return tileMap;
+	}
+
+	u32 CountWalkableNeighbours(const TileMap& tileMap, const u32 x, const u32 y)
+	{
+		u32 count{};
+		if (0U < x && tileMap.IsWalkable(x - 1U, y)) { ++count; }
+		if (x + 1U < tileMap.width && tileMap.IsWalkable(x + 1U, y)) { ++count; }
+		if (0U < y && tileMap.IsWalkable(x, y - 1U)) { ++count; }
+		if (y + 1U < tileMap.height && tileMap.IsWalkable(x, y + 1U)) { ++count; }
+		return count;
+	}
+
+	/*
+	* Recursive backtracker on the cells at odd coordinates. Walls sit on the even ones.
+	*/
+	TileMap GeneratePerfectMaze(const u32 width, const u32 height, std::mt19937& generator)
+	{
+		TileMap tileMap = MakeTileMap(width, height, false);
+
+		const u32 numCellsX = (width - 1U) / 2U;
+		const u32 numCellsY = (height - 1U) / 2U;
+
+		std::vector<u8> visitedCells((size_t)numCellsX * numCellsY, 0U);
+		std::vector<TileCoordinate> stack{};
+		stack.reserve((size_t)numCellsX * numCellsY);
+
+		stack.push_back(TileCoordinate{ 0U, 0U });
+		visitedCells[0] = 1U;
+		SetWalkable(tileMap, 1U, 1U, true);
+
+		constexpr int32 directions[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+		while (false == stack.empty()) {
+
+			const TileCoordinate cell = stack.back();
+
+			u32 candidates[4]{};
+			u32 numCandidates{};
+			for (u32 i = 0U; i < 4U; ++i) {
+				const int64 nextX = (int64)cell.X + directions[i][0];
+				const int64 nextY = (int64)cell.Y + directions[i][1];
+				if (nextX < 0 || nextY < 0 || nextX >= numCellsX || nextY >= numCellsY) { continue; }
+				if (0U == visitedCells[(size_t)nextY * numCellsX + (size_t)nextX]) {
+					candidates[numCandidates] = i;
+					++numCandidates;
+				}
+			}
+
+			if (0U == numCandidates) {
+				stack.pop_back();
+				continue;
+			}
+
+			const u32 direction = candidates[std::uniform_int_distribution<u32>{ 0U, numCandidates - 1U }(generator)];
+			const TileCoordinate nextCell{ (u32)((int32)cell.X + directions[direction][0]), (u32)((int32)cell.Y + directions[direction][1]) };
+
+			visitedCells[(size_t)nextCell.Y * numCellsX + nextCell.X] = 1U;
+			SetWalkable(tileMap, cell.X + nextCell.X + 1U, cell.Y + nextCell.Y + 1U, true);
+			SetWalkable(tileMap, 2U * nextCell.X + 1U, 2U * nextCell.Y + 1U, true);
+			stack.push_back(nextCell);
+		}
+
+		return tileMap;
+	}
+
+	/*
+	* Square rooms separated by 1 tile thick walls with a door to every neighbouring room.
+	*/
+	TileMap GenerateOpenRooms(const u32 width, const u32 height, std::mt19937& generator)
+	{
+		constexpr u32 roomStride = 8U;
+
+		TileMap tileMap = MakeTileMap(width, height, true);
+
+		for (u32 y = 0U; y < height; ++y) {
+			for (u32 x = 0U; x < width; ++x) {
+				if (0U == x % roomStride || 0U == y % roomStride || width - 1U == x || height - 1U == y) {
+					SetWalkable(tileMap, x, y, false);
+				}
+			}
+		}
+
+		std::uniform_int_distribution<u32> doorOffset{ 1U, roomStride - 1U };
+		for (u32 roomY = 0U; roomY < height; roomY += roomStride) {
+			for (u32 roomX = 0U; roomX < width; roomX += roomStride) {
+
+				const u32 wallX = roomX + roomStride;
+				const u32 doorY = roomY + doorOffset(generator);
+				if (wallX + 1U < width - 1U && doorY < height - 1U) {
+					SetWalkable(tileMap, wallX, doorY, true);
+				}
+
+				const u32 wallY = roomY + roomStride;
+				const u32 doorX = roomX + doorOffset(generator);
+				if (wallY + 1U < height - 1U && doorX < width - 1U) {
+					SetWalkable(tileMap, doorX, wallY, true);
+				}
+			}
+		}
+
+		return tileMap;
+	}
+
+	/*
+	* Only the largest group of connected walkable tiles is kept.
+	*/
+	void KeepLargestConnectedRegion(TileMap& tileMap)
+	{
+		const u32 width = tileMap.width;
+		const u32 height = tileMap.height;
+
+		std::vector<u32> regions((size_t)width * height, 0U);
+		std::vector<u32> stack{};
+		u32 numRegions{};
+		u32 largestRegion{};
+		size_t largestRegionSize{};
+
+		for (size_t start = 0U; start < regions.size(); ++start) {
+			if (0U == tileMap.walkable[start] || 0U != regions[start]) { continue; }
+
+			++numRegions;
+			size_t regionSize{};
+			regions[start] = numRegions;
+			stack.push_back((u32)start);
+
+			while (false == stack.empty()) {
+				const u32 tileIndex = stack.back();
+				stack.pop_back();
+				++regionSize;
+
+				const u32 x = tileIndex % width;
+				const u32 y = tileIndex / width;
+				const u32 neighbours[4] = {
+					(0U < x) ? tileIndex - 1U : tileIndex,
+					(x + 1U < width) ? tileIndex + 1U : tileIndex,
+					(0U < y) ? tileIndex - width : tileIndex,
+					(y + 1U < height) ? tileIndex + width : tileIndex };
+
+				for (const u32 neighbour : neighbours) {
+					if (0U != tileMap.walkable[neighbour] && 0U == regions[neighbour]) {
+						regions[neighbour] = numRegions;
+						stack.push_back(neighbour);
+					}
+				}
+			}
+
+			if (largestRegionSize < regionSize) {
+				largestRegionSize = regionSize;
+				largestRegion = numRegions;
+			}
+		}
+
+		for (size_t i = 0U; i < regions.size(); ++i) {
+			if (largestRegion != regions[i]) {
+				tileMap.walkable[i] = 0U;
+			}
+		}
+	}
+
+	/*
+	* Cellular automaton smoothing of random noise.
+	*/
+	TileMap GenerateCave(const u32 width, const u32 height, std::mt19937& generator)
+	{
+		constexpr u32 numSmoothingSteps = 4U;
+
+		TileMap tileMap = MakeTileMap(width, height, false);
+
+		std::bernoulli_distribution isOpen{ 0.55 };
+		for (u32 y = 1U; y < height - 1U; ++y) {
+			for (u32 x = 1U; x < width - 1U; ++x) {
+				SetWalkable(tileMap, x, y, isOpen(generator));
+			}
+		}
+
+		TileMap smoothedTileMap = tileMap;
+		for (u32 step = 0U; step < numSmoothingSteps; ++step) {
+			for (u32 y = 1U; y < height - 1U; ++y) {
+				for (u32 x = 1U; x < width - 1U; ++x) {
+
+					u32 numWalls{};
+					for (u32 neighbourY = y - 1U; neighbourY <= y + 1U; ++neighbourY) {
+						for (u32 neighbourX = x - 1U; neighbourX <= x + 1U; ++neighbourX) {
+							if (false == tileMap.IsWalkable(neighbourX, neighbourY)) { ++numWalls; }
+						}
+					}
+					SetWalkable(smoothedTileMap, x, y, numWalls < 5U);
+				}
+			}
+			std::swap(tileMap, smoothedTileMap);
+		}
+
+		KeepLargestConnectedRegion(tileMap);
+		return tileMap;
+	}
+
+	/*
+	* Perfect maze with all of its dead ends opened into a neighbouring corridor, 
+	* which leaves the loops and junctions typical for Pac-Man levels.
+	*/
+	TileMap GeneratePacManLevel(const u32 width, const u32 height, std::mt19937& generator)
+	{
+		TileMap tileMap = GeneratePerfectMaze(width, height, generator);
+
+		constexpr int32 directions[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+
+		for (u32 y = 1U; y < height - 1U; y += 2U) {
+			for (u32 x = 1U; x < width - 1U; x += 2U) {
+
+				if (false == tileMap.IsWalkable(x, y) || 1U != CountWalkableNeighbours(tileMap, x, y)) { continue; }
+
+				u32 candidates[4]{};
+				u32 numCandidates{};
+				for (u32 i = 0U; i < 4U; ++i) {
+					const int64 wallX = (int64)x + directions[i][0];
+					const int64 wallY = (int64)y + directions[i][1];
+					const int64 cellX = (int64)x + 2 * directions[i][0];
+					const int64 cellY = (int64)y + 2 * directions[i][1];
+					if (cellX <= 0 || cellY <= 0 || cellX >= (int64)width - 1 || cellY >= (int64)height - 1) { continue; }
+					if (false == tileMap.IsWalkable((u32)wallX, (u32)wallY) && tileMap.IsWalkable((u32)cellX, (u32)cellY)) {
+						candidates[numCandidates] = i;
+						++numCandidates;
+					}
+				}
+
+				if (0U != numCandidates) {
+					const u32 direction = candidates[std::uniform_int_distribution<u32>{ 0U, numCandidates - 1U }(generator)];
+					SetWalkable(tileMap, (u32)((int32)x + directions[direction][0]), (u32)((int32)y + directions[direction][1]), true);
+				}
+			}
+		}
+
+		return tileMap;
+	}
+}
+
+
+
+bool TileMap::IsWalkable(const u32 x, const u32 y) const
+{
+	return 0U != walkable[(size_t)y * width + x];
+}
+
+const char* GetMazeKindName(const MazeKind kind)
+{
+	switch (kind) {
+	case MazeKind::PerfectMaze: return "PerfectMaze";
+	case MazeKind::OpenRooms: return "OpenRooms";
+	case MazeKind::Cave: return "Cave";
+	case MazeKind::PacManLevel: return "PacManLevel";
+	default: return "Unknown";
+	}
+}
+
+TileMap GenerateTileMap(const MazeKind kind, const u32 width, const u32 height, const u32 seed)
+{
+	check(8U <= width && 8U <= height);
+
+	std::mt19937 generator{ seed };
+
+	switch (kind) {
+	case MazeKind::PerfectMaze: return GeneratePerfectMaze(width, height, generator);
+	case MazeKind::OpenRooms: return GenerateOpenRooms(width, height, generator);
+	case MazeKind::Cave: return GenerateCave(width, height, generator);
+	case MazeKind::PacManLevel: return GeneratePacManLevel(width, height, generator);
+	default: check(false); return TileMap{};
+	}
+}
+
+void FillMazeGraph(const TileMap& tileMap, MazeGraph& mazeGraph)
+{
+	mazeGraph.Init(tileMap.width, tileMap.height);
+
+	for (u32 y = 0U; y < tileMap.height; ++y) {
+		for (u32 x = 0U; x < tileMap.width; ++x) {
+
+			if (false == tileMap.IsWalkable(x, y)) { continue; }
+
+			if (x + 1U < tileMap.width && tileMap.IsWalkable(x + 1U, y)) {
+				mazeGraph.AddEdge(TileCoordinate{ x, y }, TileCoordinate{ x + 1U, y });
+			}
+			if (y + 1U < tileMap.height && tileMap.IsWalkable(x, y + 1U)) {
+				mazeGraph.AddEdge(TileCoordinate{ x, y }, TileCoordinate{ x, y + 1U });
+			}
+		}
+	}
+}
+
+std::vector<TileCoordinate> GetWalkableTiles(const TileMap& tileMap)
+{
+	std::vector<TileCoordinate> walkableTiles{};
+
+	for (u32 y = 0U; y < tileMap.height; ++y) {
+		for (u32 x = 0U; x < tileMap.width; ++x) {
+			if (tileMap.IsWalkable(x, y) && 0U != CountWalkableNeighbours(tileMap, x, y)) {
+				walkableTiles.push_back(TileCoordinate{ x, y });
+			}
+		}
+	}
+
+	return walkableTiles;
+}
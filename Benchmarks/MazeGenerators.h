@@ -0,0 +1,45 @@
+
+#pragma once
+
+#include "CommonTypes.h"
+
+#include <vector>
+
+class MazeGraph;
+
+enum class MazeKind : u8
+{
+	PerfectMaze,
+	OpenRooms,
+	Cave,
+	PacManLevel,
+	Count
+};
+
+/*
+* Walkability of every tile of a generated map. Every walkable tile
+* is reachable from every other one so the maps can be fed to MazeGraph as is.
+*/
+struct TileMap final
+{
+	[[nodiscard]] bool IsWalkable(const u32 x, const u32 y) const;
+
+	u32 width{};
+	u32 height{};
+	std::vector<u8> walkable{};
+};
+
+[[nodiscard]] const char* GetMazeKindName(const MazeKind kind);
+
+/*
+* Same kind, dimensions and seed always produce the same map.
+* Dimensions smaller than 8 are not supported.
+*/
+[[nodiscard]] TileMap GenerateTileMap(const MazeKind kind, const u32 width, const u32 height, const u32 seed);
+
+/*
+* Initializes the graph and adds an edge between every pair of horizontally or vertically adjacent walkable tiles.
+*/
+void FillMazeGraph(const TileMap& tileMap, MazeGraph& mazeGraph);
+
+[[nodiscard]] std::vector<TileCoordinate> GetWalkableTiles(const TileMap& tileMap);
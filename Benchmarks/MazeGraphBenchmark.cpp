@@ -0,0 +1,871 @@
+
+
+#include "MazeGenerators.h"
+#include "MazeGraph.h"
+#include "Path.h"
+#include "PathRandomStream.h"
+#include "ReservationTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+/*
+* Runs every benchmark on every kind of generated map for each size
+* from 32x32 up to the maximum size and prints the mean time per operation.
+* 
+* Usage: MazeGraphBenchmark [--max-size N] [--min-time-ms N] [--seed N] [--csv]
+*/
+
+namespace
+{
+	struct BenchmarkSettings final
+	{
+		u32 minSize{ 32U };
+		u32 maxSize{ 4096U };
+		double minTimeSeconds{ 0.25 };
+		u32 seed{ 1U };
+		bool csv{ false };
+	};
+
+	/*
+	* Every result is folded into this so that the compiler cannot drop the measured calls.
+	*/
+	u64 resultChecksum{};
+
+	void ConsumePath(const TArrayTilesInline16& path)
+	{
+		resultChecksum += (u64)path.Num();
+		resultChecksum ^= (u64)path[path.Num() - 1].X << 32U | path[path.Num() - 1].Y;
+	}
+
+	void ValidatePath(const MazeGraph& mazeGraph, const TArrayTilesInline16& path, const TileCoordinate source, const char* benchmarkName)
+	{
+		bool isValid = (0 != path.Num()) && (source == path[0]);
+		for (int32 i = 1; isValid && i < path.Num(); ++i) {
+			isValid = mazeGraph.IsAdjacent(path[i - 1], path[i]);
+		}
+
+		if (false == isValid) {
+			std::fprintf(stderr, "%s returned an invalid path\n", benchmarkName);
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	constexpr u64 UnreachableCost = std::numeric_limits<u64>::max();
+	constexpr TileCoordinate NoTileToAvoid{ std::numeric_limits<u32>::max(), std::numeric_limits<u32>::max() };
+
+	/*
+	* What the reference search sees of the map. It shares no code with MazeGraph.
+	* Entering a tile costs its entry in tileCosts, or 1 for every tile when tileCosts 
+	* is empty. closedEdges holds pairs of tile indices, the smaller one first.
+	*/
+	struct ReferenceMap final
+	{
+		const TileMap* tileMap{};
+		std::vector<u8> tileCosts{};
+		std::set<std::pair<u32, u32>> closedEdges{};
+	};
+
+	u32 GetTileIndex(const TileMap& tileMap, const TileCoordinate tileCoord)
+	{
+		return tileCoord.Y * tileMap.width + tileCoord.X;
+	}
+
+	std::pair<u32, u32> MakeReferenceEdge(const TileMap& tileMap, const TileCoordinate v, const TileCoordinate w)
+	{
+		return std::minmax(GetTileIndex(tileMap, v), GetTileIndex(tileMap, w));
+	}
+
+	/*
+	* Cost of the cheapest path from source to target that never enters tileToAvoid,
+	* found with Dijkstra, or a breadth first search when every tile costs 1.
+	*/
+	u64 ComputeReferencePathCost(const ReferenceMap& referenceMap, const TileCoordinate source, const TileCoordinate target
+		, const TileCoordinate tileToAvoid = NoTileToAvoid)
+	{
+		const TileMap& tileMap = *referenceMap.tileMap;
+		const u32 sourceIndex = GetTileIndex(tileMap, source);
+		const u32 targetIndex = GetTileIndex(tileMap, target);
+		const u32 tileToAvoidIndex = (NoTileToAvoid == tileToAvoid) ? std::numeric_limits<u32>::max() : GetTileIndex(tileMap, tileToAvoid);
+		if (sourceIndex == tileToAvoidIndex || targetIndex == tileToAvoidIndex) { return (sourceIndex == targetIndex) ? 0U : UnreachableCost; }
+
+		std::vector<u64> costs(tileMap.walkable.size(), UnreachableCost);
+		typedef std::pair<u64, u32> QueuedTile;
+		std::priority_queue<QueuedTile, std::vector<QueuedTile>, std::greater<QueuedTile>> costQueue{};
+		std::deque<u32> queue{};
+		const bool isUnweighted = referenceMap.tileCosts.empty();
+
+		costs[sourceIndex] = 0U;
+		if (isUnweighted) { queue.push_back(sourceIndex); }
+		else { costQueue.push({ 0U, sourceIndex }); }
+
+		while (false == queue.empty() || false == costQueue.empty()) {
+
+			u32 currentIndex{};
+			if (isUnweighted) {
+				currentIndex = queue.front();
+				queue.pop_front();
+			}
+			else {
+				const QueuedTile queuedTile = costQueue.top();
+				costQueue.pop();
+				if (queuedTile.first != costs[queuedTile.second]) { continue; }
+				currentIndex = queuedTile.second;
+			}
+
+			if (currentIndex == targetIndex) { return costs[currentIndex]; }
+
+			const u32 x = currentIndex % tileMap.width;
+			const u32 y = currentIndex / tileMap.width;
+			const TileCoordinate adjacentTiles[4] = { { x + 1U, y }, { x - 1U, y }, { x, y + 1U }, { x, y - 1U } };
+			for (const auto adjacentTile : adjacentTiles) {
+
+				if (adjacentTile.X >= tileMap.width || adjacentTile.Y >= tileMap.height || false == tileMap.IsWalkable(adjacentTile.X, adjacentTile.Y)) { continue; }
+
+				const u32 adjacentIndex = GetTileIndex(tileMap, adjacentTile);
+				if (adjacentIndex == tileToAvoidIndex || 0U != referenceMap.closedEdges.count(std::minmax(currentIndex, adjacentIndex))) { continue; }
+
+				const u64 adjacentCost = costs[currentIndex] + (isUnweighted ? 1U : FMath::Max<u8>(referenceMap.tileCosts[adjacentIndex], 1U));
+				if (adjacentCost < costs[adjacentIndex]) {
+					costs[adjacentIndex] = adjacentCost;
+					if (isUnweighted) { queue.push_back(adjacentIndex); }
+					else { costQueue.push({ adjacentCost, adjacentIndex }); }
+				}
+			}
+		}
+
+		return UnreachableCost;
+	}
+
+	/*
+	* Aborts unless the path is valid, ends on the target and costs as much as the cheapest path 
+	* found by the reference search. When the target cannot be reached the path has to be only the source.
+	*/
+	void ValidatePathAgainstReference(const MazeGraph& mazeGraph, const ReferenceMap& referenceMap, const TArrayTilesInline16& path
+		, const TileCoordinate source, const TileCoordinate target, const char* benchmarkName, const TileCoordinate tileToAvoid = NoTileToAvoid)
+	{
+		ValidatePath(mazeGraph, path, source, benchmarkName);
+
+		const u64 referenceCost = ComputeReferencePathCost(referenceMap, source, target, tileToAvoid);
+		const bool isUnreachable = (UnreachableCost == referenceCost);
+
+		u64 pathCost{};
+		bool entersTileToAvoid{ false };
+		for (int32 i = 1; i < path.Num(); ++i) {
+			pathCost += referenceMap.tileCosts.empty() ? 1U : FMath::Max<u8>(referenceMap.tileCosts[GetTileIndex(*referenceMap.tileMap, path[i])], 1U);
+			entersTileToAvoid = entersTileToAvoid || (tileToAvoid == path[i]);
+		}
+
+		const bool isValid = isUnreachable ? (1 == path.Num())
+			: (target == path[path.Num() - 1] && referenceCost == pathCost && false == entersTileToAvoid);
+		if (false == isValid) {
+			std::fprintf(stderr, "%s returned a path from (%u, %u) to (%u, %u) costing %llu instead of %llu\n", benchmarkName, source.X, source.Y
+				, target.X, target.Y, (unsigned long long)pathCost, (unsigned long long)referenceCost);
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	* Generates a random walk, or a patrol, twice from streams with the same seed and sequence and 
+	* aborts if the paths differ, if the length is out of bounds or if the walk steps straight back 
+	* anywhere but at a dead end. A patrol also has to walk back the same way to the source.
+	*/
+	void ValidateRandomWalk(const MazeGraph& mazeGraph, const TileCoordinate source, const u64 seed, const u32 minLength, const u32 maxLength, const bool isPatrol)
+	{
+		const char* benchmarkName = isPatrol ? "GenerateRandomPatrolFromSource" : "GenerateRandomWalkFromSource";
+		const auto fail = [benchmarkName](const char* reason) {
+			std::fprintf(stderr, "%s returned a path that %s\n", benchmarkName, reason);
+			std::exit(EXIT_FAILURE);
+		};
+
+		constexpr u64 sequence = 7U;
+		PathRandomStream randomStream{ seed, sequence };
+		PathRandomStream replayedRandomStream{ seed, sequence };
+		const auto path = isPatrol ? mazeGraph.GenerateRandomPatrolFromSource(source, randomStream, minLength, maxLength)
+			: mazeGraph.GenerateRandomWalkFromSource(source, randomStream, minLength, maxLength);
+		const auto replayedPath = isPatrol ? mazeGraph.GenerateRandomPatrolFromSource(source, replayedRandomStream, minLength, maxLength)
+			: mazeGraph.GenerateRandomWalkFromSource(source, replayedRandomStream, minLength, maxLength);
+
+		ValidatePath(mazeGraph, path, source, benchmarkName);
+
+		bool isReplayed = (path.Num() == replayedPath.Num());
+		for (int32 i = 0; isReplayed && i < path.Num(); ++i) {
+			isReplayed = (path[i] == replayedPath[i]);
+		}
+		if (false == isReplayed) {
+			fail("was not replayed by a stream with the same seed and sequence");
+		}
+
+		const u32 length = (u32)path.Num() - 1U;
+		const u32 lengthGranularity = isPatrol ? 2U : 1U;
+		const u32 minAllowedLength = (minLength + lengthGranularity - 1U) / lengthGranularity * lengthGranularity;
+		const u32 maxAllowedLength = (maxLength + lengthGranularity - 1U) / lengthGranularity * lengthGranularity;
+		if (length < minAllowedLength || length > maxAllowedLength || 0U != length % lengthGranularity) {
+			fail("has a length out of bounds");
+		}
+
+		const int32 numOutwardTiles = isPatrol ? (int32)(length / 2U) + 1 : path.Num();
+		for (int32 i = 2; i < numOutwardTiles; ++i) {
+			if (path[i] == path[i - 2] && 1 != mazeGraph.GetAllAdjacentVertices(path[i - 1]).Num()) {
+				fail("steps straight back away from a dead end");
+			}
+		}
+
+		for (int32 i = numOutwardTiles; i < path.Num(); ++i) {
+			if (path[i] != path[path.Num() - 1 - i]) {
+				fail("does not walk back the same way to the source");
+			}
+		}
+	}
+
+	/*
+	* Edits copies of the graph through their overlays and aborts if the original sees any of the edits,
+	* if a copy does not, or if undoing the edits leaves modifications behind.
+	*/
+	void ValidateEdgeModificationsOnCopies(const MazeGraph& mazeGraph, const TileCoordinate source, const TileCoordinate target)
+	{
+		const auto fail = [](const char* reason) {
+			std::fprintf(stderr, "Edge modifications on a copy: %s\n", reason);
+			std::exit(EXIT_FAILURE);
+		};
+
+		const u32 numEdges = mazeGraph.GetTotalNumEdges();
+		const int32 shortestPathNum = mazeGraph.GenerateShortestPathFromSourceToTarget(source, target).Num();
+		const auto adjacentTiles = mazeGraph.GetAllAdjacentVertices(source);
+		const TileCoordinate neighbour = adjacentTiles[0];
+
+		MazeGraph mazeGraphCopy = mazeGraph;
+		mazeGraphCopy.CloseEdge(source, neighbour);
+		if (mazeGraphCopy.IsAdjacent(source, neighbour) || 2U != mazeGraphCopy.GetTotalNumEdgeModifications() || numEdges - 1U != mazeGraphCopy.GetTotalNumEdges()) {
+			fail("CloseEdge was not applied to the copy");
+		}
+		if (false == mazeGraph.IsAdjacent(source, neighbour) || 0U != mazeGraph.GetTotalNumEdgeModifications() || numEdges != mazeGraph.GetTotalNumEdges()) {
+			fail("CloseEdge on the copy changed the original");
+		}
+
+		mazeGraphCopy.OpenEdge(source, neighbour);
+		if (false == mazeGraphCopy.IsAdjacent(source, neighbour) || 0U != mazeGraphCopy.GetTotalNumEdgeModifications()) {
+			fail("OpenEdge did not undo CloseEdge");
+		}
+
+		mazeGraphCopy.CloseEdge(source, neighbour);
+		MazeGraph copyOfCopy = mazeGraphCopy;
+		copyOfCopy.AddEdge(source, neighbour);
+		if (false == copyOfCopy.IsAdjacent(source, neighbour) || 0U != copyOfCopy.GetTotalNumEdgeModifications()) {
+			fail("AddEdge after CloseEdge left modifications behind");
+		}
+		if (mazeGraphCopy.IsAdjacent(source, neighbour) || false == mazeGraph.IsAdjacent(source, neighbour)) {
+			fail("AddEdge on a copy changed the graph it was copied from");
+		}
+
+		for (const auto adjacentTile : adjacentTiles) {
+			mazeGraphCopy.CloseEdge(source, adjacentTile);
+		}
+		if (source != target && 1 != mazeGraphCopy.GenerateShortestPathFromSourceToTarget(source, target).Num()) {
+			fail("a path left a tile whose edges were all closed");
+		}
+		if (shortestPathNum != mazeGraph.GenerateShortestPathFromSourceToTarget(source, target).Num()) {
+			fail("closing edges on the copy changed paths on the original");
+		}
+
+		mazeGraphCopy.ClearEdgeModifications();
+		if (0U != mazeGraphCopy.GetTotalNumEdgeModifications() || numEdges != mazeGraphCopy.GetTotalNumEdges()
+			|| shortestPathNum != mazeGraphCopy.GenerateShortestPathFromSourceToTarget(source, target).Num()) {
+			fail("ClearEdgeModifications did not restore the copy");
+		}
+
+		mazeGraphCopy.SetTileCost(source, 5U);
+		mazeGraphCopy.CloseEdge(source, neighbour);
+		mazeGraphCopy.ClearEdgeModifications();
+		if (5U != mazeGraphCopy.GetTileCost(source) || 0U != mazeGraphCopy.GetTotalNumEdgeModifications() || 1U != mazeGraph.GetTileCost(source)) {
+			fail("SetTileCost on the copy was not kept by the copy alone");
+		}
+
+		mazeGraphCopy.SetTileCost(source, 1U);
+		if (source != target && shortestPathNum != mazeGraphCopy.GenerateShortestPathFromSourceToTarget(source, target).Num()) {
+			fail("resetting a tile cost on the copy did not restore its paths");
+		}
+	}
+
+	/*
+	* Calls the operation with increasing indices until the minimum time has passed, 
+	* always at least once, and returns the mean time of one call in nanoseconds.
+	*/
+	double MeasureNanosecondsPerOperation(const BenchmarkSettings& settings, u64& outNumIterations, const std::function<void(u64)>& operation)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		const auto startTime = Clock::now();
+		double elapsedSeconds{};
+		u64 numIterations{};
+		do {
+			operation(numIterations);
+			++numIterations;
+			elapsedSeconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+		} while (elapsedSeconds < settings.minTimeSeconds);
+
+		outNumIterations = numIterations;
+		return elapsedSeconds * 1e9 / (double)numIterations;
+	}
+
+	void PrintHeader(const BenchmarkSettings& settings)
+	{
+		if (settings.csv) {
+			std::printf("map,size,vertices,edges,benchmark,iterations,ns_per_op\n");
+		}
+		else {
+			std::printf("%-12s %-10s %10s %10s  %-28s %10s %14s\n", "map", "size", "vertices", "edges", "benchmark", "iterations", "ns/op");
+		}
+	}
+
+	void PrintResult(const BenchmarkSettings& settings, const MazeKind kind, const u32 size, const MazeGraph& mazeGraph
+		, const char* benchmarkName, const u64 numIterations, const double nanosecondsPerOperation)
+	{
+		if (settings.csv) {
+			std::printf("%s,%u,%u,%u,%s,%llu,%.1f\n", GetMazeKindName(kind), size, mazeGraph.GetTotalNumVertices(), mazeGraph.GetTotalNumEdges()
+				, benchmarkName, (unsigned long long)numIterations, nanosecondsPerOperation);
+		}
+		else {
+			char sizeText[32]{};
+			std::snprintf(sizeText, sizeof(sizeText), "%ux%u", size, size);
+			std::printf("%-12s %-10s %10u %10u  %-28s %10llu %14.1f\n", GetMazeKindName(kind), sizeText, mazeGraph.GetTotalNumVertices()
+				, mazeGraph.GetTotalNumEdges(), benchmarkName, (unsigned long long)numIterations, nanosecondsPerOperation);
+		}
+		std::fflush(stdout);
+	}
+
+	void PrintStats(const MazeGraph& mazeGraph)
+	{
+#if MAZEGRAPH_STATS
+		static const char* queryTypeNames[(u32)MazeGraphQueryType::Count] = { "ShortestPath", "PathWithFixedLength", "PathAlongDirection", "PathNotGoingThroughTile", "CheapestPath", "CooperativePath", "CooperativeRoute" };
+
+		const MazeGraphStatsSnapshot snapshot = mazeGraph.GetStatsSnapshot();
+		for (u32 i = 0U; i < (u32)MazeGraphQueryType::Count; ++i) {
+			const auto& queryTypeStats = snapshot.perQueryType[i];
+			if (0U == queryTypeStats.numQueries) { continue; }
+
+			std::printf("    stats %-24s queries %10llu  p50 expanded %8u  p99 expanded %8u  p50 length %6u  max frontier %8u\n", queryTypeNames[i]
+				, (unsigned long long)queryTypeStats.numQueries, queryTypeStats.nodesExpanded.GetApproximatePercentile(50U)
+				, queryTypeStats.nodesExpanded.GetApproximatePercentile(99U), queryTypeStats.pathLength.GetApproximatePercentile(50U)
+				, queryTypeStats.maxPeakFrontierSize);
+		}
+		std::printf("    stats tree high-water %u  queue high-water %u  queueWithLength high-water %u  costBuckets high-water %u\n"
+			, snapshot.treeHighWaterMark, snapshot.queueHighWaterMark, snapshot.queueWithLengthHighWaterMark, snapshot.costBucketsHighWaterMark);
+#else
+		(void)mazeGraph;
+#endif
+	}
+
+	/*
+	* Aborts if an agent jumps between tiles that are not adjacent, or if 2 agents
+	* are on the same tile at the same tick or swap their tiles.
+	*/
+	void ValidateCooperativePaths(const MazeGraph& mazeGraph, const std::vector<TArrayTilesInline16>& paths, const u32 windowLength)
+	{
+		for (const auto& path : paths) {
+			for (int32 i = 1; i < path.Num(); ++i) {
+				if (path[i - 1] != path[i] && false == mazeGraph.IsAdjacent(path[i - 1], path[i])) {
+					std::fprintf(stderr, "GenerateCooperativePathFromSourceToTarget returned a path jumping between tiles that are not adjacent\n");
+					std::exit(EXIT_FAILURE);
+				}
+			}
+		}
+
+		const auto getTileAtTick = [](const TArrayTilesInline16& path, const u32 tick) {
+			return path[FMath::Min((int32)tick, path.Num() - 1)];
+		};
+
+		for (u32 tick = 0U; tick <= windowLength; ++tick) {
+			for (size_t i = 0U; i < paths.size(); ++i) {
+				for (size_t j = i + 1U; j < paths.size(); ++j) {
+
+					const bool isSameTile = getTileAtTick(paths[i], tick) == getTileAtTick(paths[j], tick);
+					const bool isSwap = 0U != tick && getTileAtTick(paths[i], tick) == getTileAtTick(paths[j], tick - 1U)
+						&& getTileAtTick(paths[j], tick) == getTileAtTick(paths[i], tick - 1U);
+
+					if (isSameTile || isSwap) {
+						std::fprintf(stderr, "GenerateCooperativePathFromSourceToTarget returned conflicting paths at tick %u\n", tick);
+						std::exit(EXIT_FAILURE);
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	* Plans a window for every agent in order of priority and then moves every agent to the end of its path,
+	* which is where it is at the end of the window. When agentRoutes is given, the route of every agent 
+	* is kept in it between windows.
+	*/
+	void PlanCooperativeWindow(const MazeGraph& mazeGraph, ReservationTable& reservations, std::vector<TileCoordinate>& agentTiles
+		, const std::vector<TileCoordinate>& agentTargets, const u32 windowLength, std::vector<TArrayTilesInline16>& outPaths
+		, std::vector<TArrayTilesInline16>* agentRoutes = nullptr)
+	{
+		const u32 startTick = reservations.GetCurrentTick();
+		reservations.Clear();
+		for (const auto agentTile : agentTiles) {
+			reservations.ReserveForWindow(agentTile, startTick, windowLength);
+		}
+
+		outPaths.clear();
+		for (size_t i = 0U; i < agentTiles.size(); ++i) {
+			outPaths.push_back((nullptr == agentRoutes) 
+				? mazeGraph.GenerateCooperativePathFromSourceToTarget(agentTiles[i], agentTargets[i], reservations, startTick, windowLength)
+				: mazeGraph.GenerateCooperativePathFromSourceToTarget(agentTiles[i], agentTargets[i], reservations, startTick, windowLength, (*agentRoutes)[i]));
+			reservations.ReservePath(outPaths.back(), startTick, windowLength);
+			ConsumePath(outPaths.back());
+		}
+
+		for (size_t i = 0U; i < agentTiles.size(); ++i) {
+			agentTiles[i] = outPaths[i][outPaths[i].Num() - 1];
+		}
+	}
+
+	/*
+	* Plans many consecutive windows for a crowd of agents on distinct tiles and aborts if any window 
+	* has conflicting paths. Agents that reach their target get a new one.
+	*/
+	void ValidateDenseCooperativeWindows(const MazeGraph& mazeGraph, const std::vector<TileCoordinate>& walkableTiles, const u32 size, const u32 seed)
+	{
+		constexpr u32 numAgents = 64U;
+		constexpr u32 windowLength = 16U;
+		constexpr u32 numWindows = 8U;
+
+		std::mt19937 generator{ seed };
+		std::vector<TileCoordinate> shuffledTiles = walkableTiles;
+		std::shuffle(shuffledTiles.begin(), shuffledTiles.end(), generator);
+		std::uniform_int_distribution<size_t> tileDistribution{ 0U, walkableTiles.size() - 1U };
+
+		std::vector<TileCoordinate> agentTiles(shuffledTiles.begin(), shuffledTiles.begin() + FMath::Min<size_t>(numAgents, shuffledTiles.size()));
+		std::vector<TileCoordinate> agentTargets(agentTiles.size());
+		for (auto& agentTarget : agentTargets) {
+			agentTarget = walkableTiles[tileDistribution(generator)];
+		}
+
+		ReservationTable reservations{};
+		reservations.Init(size, size, 2U * windowLength);
+		std::vector<TArrayTilesInline16> cooperativePaths{};
+		std::vector<TArrayTilesInline16> agentRoutes(agentTiles.size());
+		for (u32 window = 0U; window < numWindows; ++window) {
+
+			PlanCooperativeWindow(mazeGraph, reservations, agentTiles, agentTargets, windowLength, cooperativePaths, &agentRoutes);
+			ValidateCooperativePaths(mazeGraph, cooperativePaths, windowLength);
+
+			for (u32 tick = 0U; tick < windowLength; ++tick) {
+				reservations.AdvanceTick();
+			}
+			for (size_t i = 0U; i < agentTiles.size(); ++i) {
+				if (agentTiles[i] == agentTargets[i]) {
+					agentTargets[i] = walkableTiles[tileDistribution(generator)];
+				}
+			}
+		}
+	}
+
+	/*
+	* Opens an edge from the center of a grid, whose vertex is already connected 
+	* to 4 vertices, to a corner and aborts if the edge exists on either side.
+	*/
+	void ValidateOpenEdgeOnFullVertex()
+	{
+		constexpr u32 gridSize = 5U;
+
+		MazeGraph mazeGraph{};
+		mazeGraph.Init(gridSize, gridSize);
+		for (u32 y = 0U; y < gridSize; ++y) {
+			for (u32 x = 0U; x < gridSize; ++x) {
+				if (0U != x) { mazeGraph.AddEdge(TileCoordinate{ x - 1U, y }, TileCoordinate{ x, y }); }
+				if (0U != y) { mazeGraph.AddEdge(TileCoordinate{ x, y - 1U }, TileCoordinate{ x, y }); }
+			}
+		}
+
+		const TileCoordinate center{ 2U, 2U };
+		const TileCoordinate corner{ 0U, 0U };
+		MazeGraph mazeGraphCopy = mazeGraph;
+		mazeGraphCopy.OpenEdge(center, corner);
+		if (mazeGraphCopy.IsAdjacent(center, corner) || mazeGraphCopy.IsAdjacent(corner, center) || 0U != mazeGraphCopy.GetTotalNumEdgeModifications()) {
+			std::fprintf(stderr, "OpenEdge connected a vertex that was already connected to 4 vertices\n");
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	* Plans a window starting after the current tick of a short table on a corridor and aborts 
+	* if the path reaches past the last tick the table keeps, where reservations are lost.
+	*/
+	void ValidateCooperativeWindowEndsWithTable()
+	{
+		constexpr u32 corridorLength = 8U;
+		constexpr u32 horizon = 8U;
+		constexpr u32 startTick = 6U;
+		constexpr u32 windowLength = 16U;
+
+		MazeGraph mazeGraph{};
+		mazeGraph.Init(corridorLength, 1U);
+		for (u32 x = 1U; x < corridorLength; ++x) {
+			mazeGraph.AddEdge(TileCoordinate{ x - 1U, 0U }, TileCoordinate{ x, 0U });
+		}
+
+		ReservationTable reservations{};
+		reservations.Init(corridorLength, 1U, horizon);
+
+		const TileCoordinate source{ 0U, 0U };
+		const TileCoordinate otherAgentTile{ corridorLength - 1U, 0U };
+		reservations.ReserveForWindow(source, startTick, windowLength);
+		reservations.ReserveForWindow(otherAgentTile, startTick, windowLength);
+
+		const auto path = mazeGraph.GenerateCooperativePathFromSourceToTarget(source, otherAgentTile, reservations, startTick, windowLength);
+		if ((u32)path.Num() > reservations.GetCurrentTick() + horizon - startTick) {
+			std::fprintf(stderr, "GenerateCooperativePathFromSourceToTarget planned past the ticks kept by the reservation table\n");
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	/*
+	* Keeps the route of an agent on a corridor, rebuilds the corridor with a gap 
+	* through Init() and aborts if the next window still follows the old route.
+	*/
+	void ValidateCooperativeRouteAfterInit()
+	{
+		constexpr u32 corridorLength = 4U;
+		constexpr u32 windowLength = 4U;
+		const TileCoordinate source{ 0U, 0U };
+		const TileCoordinate target{ corridorLength - 1U, 0U };
+
+		MazeGraph mazeGraph{};
+		mazeGraph.Init(corridorLength, 1U);
+		for (u32 x = 1U; x < corridorLength; ++x) {
+			mazeGraph.AddEdge(TileCoordinate{ x - 1U, 0U }, TileCoordinate{ x, 0U });
+		}
+
+		ReservationTable reservations{};
+		reservations.Init(corridorLength, 1U);
+		reservations.ReserveForWindow(source, reservations.GetCurrentTick(), windowLength);
+
+		TArrayTilesInline16 route{};
+		(void)mazeGraph.GenerateCooperativePathFromSourceToTarget(source, target, reservations, reservations.GetCurrentTick(), windowLength, route);
+
+		mazeGraph.Init(corridorLength, 1U);
+		mazeGraph.AddEdge(TileCoordinate{ 0U, 0U }, TileCoordinate{ 1U, 0U });
+		mazeGraph.AddEdge(TileCoordinate{ 2U, 0U }, TileCoordinate{ 3U, 0U });
+
+		(void)mazeGraph.GenerateCooperativePathFromSourceToTarget(source, target, reservations, reservations.GetCurrentTick(), windowLength, route);
+		for (int32 i = 1; i < route.Num(); ++i) {
+			if (false == mazeGraph.IsAdjacent(route[i - 1], route[i])) {
+				std::fprintf(stderr, "GenerateCooperativePathFromSourceToTarget reused a route of the graph from before Init()\n");
+				std::exit(EXIT_FAILURE);
+			}
+		}
+	}
+
+	void RunBenchmarksOnMap(const BenchmarkSettings& settings, const MazeKind kind, const u32 size)
+	{
+		constexpr u32 numSampledTiles = 1024U;
+		constexpr u32 fixedPathLength = 32U;
+
+		const TileMap tileMap = GenerateTileMap(kind, size, size, settings.seed);
+		const std::vector<TileCoordinate> walkableTiles = GetWalkableTiles(tileMap);
+		check(false == walkableTiles.empty());
+
+		std::mt19937 generator{ settings.seed };
+		std::uniform_int_distribution<size_t> tileDistribution{ 0U, walkableTiles.size() - 1U };
+		std::vector<TileCoordinate> sampledTiles(numSampledTiles);
+		for (auto& sampledTile : sampledTiles) {
+			sampledTile = walkableTiles[tileDistribution(generator)];
+		}
+
+		const auto getSampledTile = [&sampledTiles](const u64 index) {
+			return sampledTiles[index % sampledTiles.size()];
+		};
+
+		MazeGraph mazeGraph{};
+		u64 numIterations{};
+		double nanosecondsPerOperation{};
+
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64) {
+			FillMazeGraph(tileMap, mazeGraph);
+			resultChecksum += mazeGraph.GetTotalNumVertices();
+		});
+		PrintResult(settings, kind, size, mazeGraph, "Init+AddEdge", numIterations, nanosecondsPerOperation);
+
+		//The reference search visits the whole map with slower containers, so only a few queries of each kind are checked against it.
+		constexpr u32 numValidatedQueries = 4U;
+		ReferenceMap referenceMap{};
+		referenceMap.tileMap = &tileMap;
+
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidatePathAgainstReference(mazeGraph, referenceMap, mazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U))
+				, getSampledTile(i), getSampledTile(i + 1U), "GenerateShortestPathFromSourceToTarget");
+		}
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U)));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "ShortestPath", numIterations, nanosecondsPerOperation);
+
+		ValidateEdgeModificationsOnCopies(mazeGraph, getSampledTile(0U), getSampledTile(1U));
+
+		//A copy with closed doors, so that the searches read through the overlay.
+		constexpr u32 numClosedEdges = 64U;
+		MazeGraph modifiedMazeGraph = mazeGraph;
+		ReferenceMap modifiedReferenceMap = referenceMap;
+		for (u32 i = 0U; i < numClosedEdges; ++i) {
+			const TileCoordinate tileCoord = walkableTiles[tileDistribution(generator)];
+			const TileCoordinate adjacentTileCoord = mazeGraph.GetAllAdjacentVertices(tileCoord)[0];
+			modifiedMazeGraph.CloseEdge(tileCoord, adjacentTileCoord);
+			modifiedReferenceMap.closedEdges.insert(MakeReferenceEdge(tileMap, tileCoord, adjacentTileCoord));
+		}
+
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidatePathAgainstReference(modifiedMazeGraph, modifiedReferenceMap, modifiedMazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U))
+				, getSampledTile(i), getSampledTile(i + 1U), "GenerateShortestPathFromSourceToTarget with closed edges");
+		}
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(modifiedMazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U)));
+		});
+		PrintResult(settings, kind, size, modifiedMazeGraph, "ShortestPathWithClosedEdges", numIterations, nanosecondsPerOperation);
+
+		ValidatePath(mazeGraph, mazeGraph.GenerateNonTrivialRandomPathStartingFromSource(getSampledTile(0U)), getSampledTile(0U), "GenerateNonTrivialRandomPathStartingFromSource");
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GenerateNonTrivialRandomPathStartingFromSource(getSampledTile(i)));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "NonTrivialRandomPath", numIterations, nanosecondsPerOperation);
+
+		ValidatePath(mazeGraph, mazeGraph.GeneratePathWithFixedLength(getSampledTile(0U), fixedPathLength), getSampledTile(0U), "GeneratePathWithFixedLength");
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GeneratePathWithFixedLength(getSampledTile(i), fixedPathLength));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "PathWithFixedLength/32", numIterations, nanosecondsPerOperation);
+
+		constexpr FInt32Vector2 directions[4] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+		ValidatePath(mazeGraph, mazeGraph.GeneratePathAlongDirection(getSampledTile(0U), directions[0]), getSampledTile(0U), "GeneratePathAlongDirection");
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GeneratePathAlongDirection(getSampledTile(i), directions[i % 4U]));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "PathAlongDirection", numIterations, nanosecondsPerOperation);
+
+		const auto getTileToAvoid = [&mazeGraph](const TileCoordinate source) {
+			return mazeGraph.GetAllAdjacentVertices(source)[0];
+		};
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidatePathAgainstReference(mazeGraph, referenceMap, mazeGraph.GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(getSampledTile(i), getSampledTile(i + 1U)
+				, getTileToAvoid(getSampledTile(i))), getSampledTile(i), getSampledTile(i + 1U), "GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile"
+				, getTileToAvoid(getSampledTile(i)));
+		}
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(getSampledTile(i), getSampledTile(i + 1U)
+				, getTileToAvoid(getSampledTile(i))));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "PathNotGoingThroughTile", numIterations, nanosecondsPerOperation);
+
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidateRandomWalk(mazeGraph, getSampledTile(i), settings.seed + i, 16U, 64U, false);
+			ValidateRandomWalk(mazeGraph, getSampledTile(i), settings.seed + i, 15U, 63U, true);
+		}
+
+		PathRandomStream randomStream{ settings.seed };
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GenerateRandomWalkFromSource(getSampledTile(i), randomStream, 16U, 64U));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "RandomWalk/16-64", numIterations, nanosecondsPerOperation);
+
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(mazeGraph.GenerateRandomPatrolFromSource(getSampledTile(i), randomStream, 16U, 64U));
+		});
+		PrintResult(settings, kind, size, mazeGraph, "RandomPatrol/16-64", numIterations, nanosecondsPerOperation);
+
+		std::vector<TArrayTilesInline16> generatedPaths{};
+		for (u32 i = 0U; i < 64U; ++i) {
+			generatedPaths.push_back(mazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U)));
+		}
+		Path path{};
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			TArrayTilesInline16 pathToTraverse = generatedPaths[i % generatedPaths.size()];
+			path = std::move(pathToTraverse);
+			resultChecksum += path.Length() + path.PeekAhead(path.Length()).X + path.GetLastTileInPath().Y;
+			while (false == path.IsPathFullyTraversed()) {
+				resultChecksum += path.GetNextTile().X;
+			}
+			resultChecksum += path.TotalNumEdgesTraversedUntilNow();
+		});
+		PrintResult(settings, kind, size, mazeGraph, "PathTraversal", numIterations, nanosecondsPerOperation);
+
+		PrintStats(mazeGraph);
+
+#if MAZEGRAPH_STATS
+		const MazeGraph mazeGraphCopy = mazeGraph;
+		if (0U != mazeGraphCopy.GetStatsSnapshot().treeHighWaterMark) {
+			std::fprintf(stderr, "A copy of a MazeGraph kept the statistics of the original\n");
+			std::exit(EXIT_FAILURE);
+		}
+#endif
+
+		//Every fourth tile gets a cost from 2 to 8 in a separate graph, so that the costs are stored in its shared block instead of an overlay.
+		MazeGraph weightedMazeGraph{};
+		FillMazeGraph(tileMap, weightedMazeGraph);
+		ReferenceMap weightedReferenceMap = referenceMap;
+		weightedReferenceMap.tileCosts.assign(tileMap.walkable.size(), 1U);
+		std::uniform_int_distribution<u32> costDistribution{ 2U, 8U };
+		for (size_t i = 0U; i < walkableTiles.size(); i += 4U) {
+			const u8 tileCost = (u8)costDistribution(generator);
+			weightedMazeGraph.SetTileCost(walkableTiles[i], tileCost);
+			weightedReferenceMap.tileCosts[GetTileIndex(tileMap, walkableTiles[i])] = tileCost;
+		}
+
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidatePathAgainstReference(weightedMazeGraph, weightedReferenceMap, weightedMazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U))
+				, getSampledTile(i), getSampledTile(i + 1U), "GenerateShortestPathFromSourceToTarget with tile costs");
+		}
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(weightedMazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U)));
+		});
+		PrintResult(settings, kind, size, weightedMazeGraph, "ShortestPathWithTileCosts", numIterations, nanosecondsPerOperation);
+
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ValidatePathAgainstReference(weightedMazeGraph, weightedReferenceMap, weightedMazeGraph.GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(getSampledTile(i)
+				, getSampledTile(i + 1U), getTileToAvoid(getSampledTile(i))), getSampledTile(i), getSampledTile(i + 1U)
+				, "GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile with tile costs", getTileToAvoid(getSampledTile(i)));
+		}
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64 i) {
+			ConsumePath(weightedMazeGraph.GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(getSampledTile(i), getSampledTile(i + 1U)
+				, getTileToAvoid(getSampledTile(i))));
+		});
+		PrintResult(settings, kind, size, weightedMazeGraph, "PathNotGoingThroughTileWithTileCosts", numIterations, nanosecondsPerOperation);
+
+#if MAZEGRAPH_STATS
+		//A vertex can be queued once per adjacent vertex but is expanded only once.
+		const u32 numWeightedVertices = weightedMazeGraph.GetTotalNumVertices();
+		weightedMazeGraph.SetQueryTraceSink([numWeightedVertices](const MazeGraphQueryRecord& record) {
+			if (record.nodesExpanded > numWeightedVertices) {
+				std::fprintf(stderr, "A weighted search counted %u expanded vertices on a graph of %u vertices\n", record.nodesExpanded, numWeightedVertices);
+				std::exit(EXIT_FAILURE);
+			}
+		});
+		for (u32 i = 0U; i < numValidatedQueries; ++i) {
+			ConsumePath(weightedMazeGraph.GenerateShortestPathFromSourceToTarget(getSampledTile(i), getSampledTile(i + 1U)));
+		}
+		weightedMazeGraph.SetQueryTraceSink(MazeGraphQueryTraceSink{});
+#endif
+
+		PrintStats(weightedMazeGraph);
+
+		//Agents start on distinct tiles spread over the map and head to the tiles of the agents on the opposite side of the list.
+		constexpr u32 numAgents = 32U;
+		constexpr u32 windowLength = 16U;
+		std::vector<TileCoordinate> agentTiles{};
+		std::vector<TileCoordinate> agentTargets{};
+		for (u32 i = 0U; i < numAgents && i < walkableTiles.size(); ++i) {
+			agentTiles.push_back(walkableTiles[(size_t)i * walkableTiles.size() / numAgents]);
+		}
+		agentTargets.assign(agentTiles.rbegin(), agentTiles.rend());
+
+		ReservationTable reservations{};
+		reservations.Init(size, size, 2U * windowLength);
+		std::vector<TArrayTilesInline16> cooperativePaths{};
+		std::vector<TileCoordinate> validatedAgentTiles = agentTiles;
+		PlanCooperativeWindow(mazeGraph, reservations, validatedAgentTiles, agentTargets, windowLength, cooperativePaths);
+		ValidateCooperativePaths(mazeGraph, cooperativePaths, windowLength);
+
+		//Planning full windows for a crowd is slow on large maps, where it would also be sparse.
+		constexpr u32 maxDenseCooperativeValidationSize = 256U;
+		if (size <= maxDenseCooperativeValidationSize) {
+			ValidateDenseCooperativeWindows(mazeGraph, walkableTiles, size, settings.seed);
+		}
+
+		//Agents go back and forth between their start and target tiles, so that they keep moving however long the measurement takes.
+		const std::vector<TileCoordinate> agentStartTiles = agentTiles;
+		const std::vector<TileCoordinate> agentEndTiles = agentTargets;
+		const auto planWindowAndTurnAgentsAround = [&](std::vector<TArrayTilesInline16>* agentRoutes) {
+			PlanCooperativeWindow(mazeGraph, reservations, agentTiles, agentTargets, windowLength, cooperativePaths, agentRoutes);
+			for (u32 tick = 0U; tick < windowLength; ++tick) {
+				reservations.AdvanceTick();
+			}
+			for (size_t i = 0U; i < agentTiles.size(); ++i) {
+				if (agentTiles[i] == agentTargets[i]) {
+					agentTargets[i] = (agentTargets[i] == agentEndTiles[i]) ? agentStartTiles[i] : agentEndTiles[i];
+				}
+			}
+		};
+
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64) {
+			planWindowAndTurnAgentsAround(nullptr);
+		});
+		PrintResult(settings, kind, size, mazeGraph, "CooperativeWindow/32x16", numIterations, nanosecondsPerOperation);
+
+		agentTiles = agentStartTiles;
+		agentTargets = agentEndTiles;
+		std::vector<TArrayTilesInline16> agentRoutes(agentTiles.size());
+
+		//The first window searches every route, which would be most of the measurement on large maps where only a few windows fit in it.
+		planWindowAndTurnAgentsAround(&agentRoutes);
+		nanosecondsPerOperation = MeasureNanosecondsPerOperation(settings, numIterations, [&](const u64) {
+			planWindowAndTurnAgentsAround(&agentRoutes);
+		});
+		PrintResult(settings, kind, size, mazeGraph, "CooperativeWindowWithRoutes/32x16", numIterations, nanosecondsPerOperation);
+	}
+
+	bool ParseSettings(const int argc, char** argv, BenchmarkSettings& outSettings)
+	{
+		for (int i = 1; i < argc; ++i) {
+			const bool hasValue = (i + 1 < argc);
+			if (0 == std::strcmp(argv[i], "--max-size") && hasValue) {
+				outSettings.maxSize = (u32)std::strtoul(argv[++i], nullptr, 10);
+			}
+			else if (0 == std::strcmp(argv[i], "--min-time-ms") && hasValue) {
+				outSettings.minTimeSeconds = std::strtod(argv[++i], nullptr) / 1000.0;
+			}
+			else if (0 == std::strcmp(argv[i], "--seed") && hasValue) {
+				outSettings.seed = (u32)std::strtoul(argv[++i], nullptr, 10);
+			}
+			else if (0 == std::strcmp(argv[i], "--csv")) {
+				outSettings.csv = true;
+			}
+			else {
+				return false;
+			}
+		}
+
+		return outSettings.minSize <= outSettings.maxSize;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	BenchmarkSettings settings{};
+	if (false == ParseSettings(argc, argv, settings)) {
+		std::fprintf(stderr, "Usage: %s [--max-size N] [--min-time-ms N] [--seed N] [--csv]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	const MazeGraph defaultMazeGraph{};
+	if (0U != defaultMazeGraph.GetTotalNumVertices() || 0U != defaultMazeGraph.GetTotalNumEdges()) {
+		std::fprintf(stderr, "A default constructed MazeGraph is not empty\n");
+		return EXIT_FAILURE;
+	}
+
+	ValidateOpenEdgeOnFullVertex();
+	ValidateCooperativeWindowEndsWithTable();
+	ValidateCooperativeRouteAfterInit();
+
+	PrintHeader(settings);
+
+	for (u32 size = settings.minSize; size <= settings.maxSize; size *= 2U) {
+		for (u32 kind = 0U; kind < (u32)MazeKind::Count; ++kind) {
+			RunBenchmarksOnMap(settings, (MazeKind)kind, size);
+		}
+	}
+
+	std::fprintf(stderr, "checksum %llu\n", (unsigned long long)resultChecksum);
+	return EXIT_SUCCESS;
+}
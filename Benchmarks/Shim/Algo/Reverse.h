@@ -0,0 +1,15 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <algorithm>
+
+namespace Algo
+{
+	template<typename RangeType>
+	void Reverse(RangeType& range)
+	{
+		std::reverse(range.begin(), range.end());
+	}
+}
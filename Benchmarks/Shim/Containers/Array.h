@@ -0,0 +1,214 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <new>
+#include <utility>
+
+enum class EAllowShrinking : uint8
+{
+	No,
+	Yes
+};
+
+template<uint32 NumInlineElements>
+struct TInlineAllocator
+{
+};
+
+struct FDefaultAllocator
+{
+};
+
+
+/*
+* Contiguous growable storage. The allocator is accepted for source compatibility 
+* only, so TInlineAllocator arrays still allocate on the heap here.
+*/
+template<typename T, typename Allocator = FDefaultAllocator>
+class TArray
+{
+public:
+
+	TArray() = default;
+
+	TArray(const TArray& other)
+	{
+		Reserve(other._num);
+		for (const T& element : other) {
+			Add(element);
+		}
+	}
+
+	TArray(TArray&& other) noexcept
+		: _data(std::exchange(other._data, nullptr)), _num(std::exchange(other._num, 0)), _max(std::exchange(other._max, 0))
+	{
+	}
+
+	TArray& operator=(const TArray& other)
+	{
+		if (this != &other) {
+			TArray copy{ other };
+			Swap(copy);
+		}
+		return *this;
+	}
+
+	TArray& operator=(TArray&& other) noexcept
+	{
+		if (this != &other) {
+			TArray moved{ std::move(other) };
+			Swap(moved);
+		}
+		return *this;
+	}
+
+	~TArray() { Empty(); }
+
+	int32 Num() const { return _num; }
+
+	bool IsEmpty() const { return 0 == _num; }
+
+	int32 Add(const T& element)
+	{
+		if (_num == _max) {
+			T elementCopy{ element };
+			Grow(_num + 1);
+			new (_data + _num) T(std::move(elementCopy));
+		}
+		else {
+			new (_data + _num) T(element);
+		}
+		return _num++;
+	}
+
+	int32 Add(T&& element)
+	{
+		if (_num == _max) {
+			T elementMoved{ std::move(element) };
+			Grow(_num + 1);
+			new (_data + _num) T(std::move(elementMoved));
+		}
+		else {
+			new (_data + _num) T(std::move(element));
+		}
+		return _num++;
+	}
+
+	void Empty()
+	{
+		DestroyElements(0);
+		::operator delete(_data, std::align_val_t{ alignof(T) });
+		_data = nullptr;
+		_max = 0;
+	}
+
+	void Reserve(const int32 number)
+	{
+		if (_max < number) {
+			Reallocate(number);
+		}
+	}
+
+	void SetNum(const int32 number, const EAllowShrinking allowShrinking = EAllowShrinking::Yes)
+	{
+		check(0 <= number);
+		if (number < _num) {
+			DestroyElements(number);
+		}
+		else {
+			Reserve(number);
+			for (int32 i = _num; i < number; ++i) {
+				new (_data + i) T{};
+			}
+			_num = number;
+		}
+
+		if (EAllowShrinking::Yes == allowShrinking && _num < _max) {
+			Reallocate(_num);
+		}
+	}
+
+	void SetNumUninitialized(const int32 number, const EAllowShrinking allowShrinking = EAllowShrinking::Yes)
+	{
+		SetNum(number, allowShrinking);
+	}
+
+	T* GetData() { return _data; }
+	const T* GetData() const { return _data; }
+
+	T& operator[](const int32 index) { check(0 <= index && index < _num); return _data[index]; }
+	const T& operator[](const int32 index) const { check(0 <= index && index < _num); return _data[index]; }
+
+	T Pop(const EAllowShrinking allowShrinking = EAllowShrinking::Yes)
+	{
+		check(0 != _num);
+		T element{ std::move(_data[_num - 1]) };
+		SetNum(_num - 1, allowShrinking);
+		return element;
+	}
+
+	int32 Find(const T& element) const
+	{
+		for (int32 i = 0; i < _num; ++i) {
+			if (element == _data[i]) { return i; }
+		}
+		return INDEX_NONE;
+	}
+
+	void RemoveAt(const int32 index, const int32 count, const EAllowShrinking allowShrinking = EAllowShrinking::Yes)
+	{
+		check(0 <= index && 0 <= count && index + count <= _num);
+		for (int32 i = index; i + count < _num; ++i) {
+			_data[i] = std::move(_data[i + count]);
+		}
+		SetNum(_num - count, allowShrinking);
+	}
+
+	T& Last() { check(0 != _num); return _data[_num - 1]; }
+	const T& Last() const { check(0 != _num); return _data[_num - 1]; }
+
+	T* begin() { return _data; }
+	T* end() { return _data + _num; }
+	const T* begin() const { return _data; }
+	const T* end() const { return _data + _num; }
+
+private:
+
+	void Swap(TArray& other) noexcept
+	{
+		std::swap(_data, other._data);
+		std::swap(_num, other._num);
+		std::swap(_max, other._max);
+	}
+
+	void DestroyElements(const int32 firstIndex)
+	{
+		for (int32 i = firstIndex; i < _num; ++i) {
+			_data[i].~T();
+		}
+		_num = FMath::Min(_num, firstIndex);
+	}
+
+	void Grow(const int32 minNumber)
+	{
+		Reallocate(FMath::Max(minNumber, _max + _max / 2 + 4));
+	}
+
+	void Reallocate(const int32 newMax)
+	{
+		T* newData = (0 == newMax) ? nullptr : static_cast<T*>(::operator new(sizeof(T) * (size_t)newMax, std::align_val_t{ alignof(T) }));
+		for (int32 i = 0; i < _num; ++i) {
+			new (newData + i) T(std::move(_data[i]));
+			_data[i].~T();
+		}
+		::operator delete(_data, std::align_val_t{ alignof(T) });
+		_data = newData;
+		_max = newMax;
+	}
+
+	T* _data{};
+	int32 _num{};
+	int32 _max{};
+};
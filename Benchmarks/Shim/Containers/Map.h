@@ -0,0 +1,100 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <unordered_map>
+#include <vector>
+
+template<typename KeyType, typename ValueType>
+struct TPair
+{
+	KeyType Key{};
+	ValueType Value{};
+};
+
+/*
+* Pairs are stored contiguously and looked up through a hash index,
+* which is close to how the engine lays out its maps.
+*/
+template<typename KeyType, typename ValueType>
+class TMap
+{
+public:
+
+	int32 Num() const { return (int32)_pairs.size(); }
+
+	ValueType* Find(const KeyType& key)
+	{
+		const auto foundIndex = _indices.find(key);
+		return (_indices.end() == foundIndex) ? nullptr : &_pairs[foundIndex->second].Value;
+	}
+
+	const ValueType* Find(const KeyType& key) const
+	{
+		const auto foundIndex = _indices.find(key);
+		return (_indices.end() == foundIndex) ? nullptr : &_pairs[foundIndex->second].Value;
+	}
+
+	ValueType& FindOrAdd(const KeyType& key, const ValueType& value)
+	{
+		if (ValueType* foundValue = Find(key)) {
+			return *foundValue;
+		}
+		_indices.emplace(key, _pairs.size());
+		_pairs.push_back(TPair<KeyType, ValueType>{ key, value });
+		return _pairs.back().Value;
+	}
+
+	ValueType& Add(const KeyType& key, const ValueType& value)
+	{
+		if (ValueType* foundValue = Find(key)) {
+			*foundValue = value;
+			return *foundValue;
+		}
+		return FindOrAdd(key, value);
+	}
+
+	ValueType& FindOrAdd(const KeyType& key)
+	{
+		return FindOrAdd(key, ValueType{});
+	}
+
+	int32 Remove(const KeyType& key)
+	{
+		const auto foundIndex = _indices.find(key);
+		if (_indices.end() == foundIndex) { return 0; }
+
+		const size_t removedIndex = foundIndex->second;
+		_indices.erase(foundIndex);
+		if (removedIndex != _pairs.size() - 1U) {
+			_pairs[removedIndex] = std::move(_pairs.back());
+			_indices[_pairs[removedIndex].Key] = removedIndex;
+		}
+		_pairs.pop_back();
+		return 1;
+	}
+
+	//Like the engine, Empty() frees the allocations and Reset() keeps them for reuse.
+	void Empty()
+	{
+		_pairs = std::vector<TPair<KeyType, ValueType>>{};
+		_indices = std::unordered_map<KeyType, size_t>{};
+	}
+
+	void Reset()
+	{
+		_pairs.clear();
+		_indices.clear();
+	}
+
+	auto begin() { return _pairs.begin(); }
+	auto end() { return _pairs.end(); }
+	auto begin() const { return _pairs.begin(); }
+	auto end() const { return _pairs.end(); }
+
+private:
+
+	std::vector<TPair<KeyType, ValueType>> _pairs{};
+	std::unordered_map<KeyType, size_t> _indices{};
+};
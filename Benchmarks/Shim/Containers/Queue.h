@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Single producer single consumer linked list like the engine version,
+* so every Enqueue() pays for a node allocation just as it does in the engine.
+*/
+template<typename T>
+class TQueue
+{
+public:
+
+	TQueue() = default;
+	TQueue(const TQueue&) = delete;
+	TQueue& operator=(const TQueue&) = delete;
+
+	~TQueue() { Empty(); }
+
+	bool Enqueue(const T& item)
+	{
+		Node* newNode = new Node{ item, nullptr };
+		if (nullptr == _tail) {
+			_head = newNode;
+		}
+		else {
+			_tail->next = newNode;
+		}
+		_tail = newNode;
+		return true;
+	}
+
+	bool Dequeue(T& outItem)
+	{
+		if (nullptr == _head) { return false; }
+
+		Node* oldHead = _head;
+		outItem = std::move(oldHead->item);
+		_head = oldHead->next;
+		if (nullptr == _head) {
+			_tail = nullptr;
+		}
+		delete oldHead;
+		return true;
+	}
+
+	bool IsEmpty() const { return nullptr == _head; }
+
+	void Empty()
+	{
+		T item{};
+		while (Dequeue(item)) {}
+	}
+
+private:
+
+	struct Node
+	{
+		T item{};
+		Node* next{};
+	};
+
+	Node* _head{};
+	Node* _tail{};
+};
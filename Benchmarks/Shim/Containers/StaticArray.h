@@ -0,0 +1,36 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <initializer_list>
+
+template<typename T, uint32 NumElements>
+class TStaticArray
+{
+public:
+
+	TStaticArray() = default;
+
+	TStaticArray(std::initializer_list<T> initialElements)
+	{
+		uint32 i{};
+		for (const auto& element : initialElements) {
+			if (NumElements == i) { break; }
+			_elements[i] = element;
+			++i;
+		}
+	}
+
+	static constexpr int32 Num() { return (int32)NumElements; }
+
+	T* GetData() { return _elements; }
+	const T* GetData() const { return _elements; }
+
+	T& operator[](const uint64 index) { check(index < NumElements); return _elements[index]; }
+	const T& operator[](const uint64 index) const { check(index < NumElements); return _elements[index]; }
+
+private:
+
+	T _elements[NumElements]{};
+};
@@ -0,0 +1,102 @@
+
+#pragma once
+
+/*
+* Minimal stand-in for the parts of the Unreal core module that MazeGraph and Path
+* use, so that they can be built and measured outside of the engine. Only
+* the members used by the sources in Source/ are provided.
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <utility>
+
+typedef std::uint8_t uint8;
+typedef std::uint32_t uint32;
+typedef std::uint64_t uint64;
+typedef std::int32_t int32;
+typedef std::int64_t int64;
+
+#ifndef PACMANUE_API
+#define PACMANUE_API
+#endif
+
+#define INDEX_NONE -1
+
+#ifdef NDEBUG
+#define check(expr) ((void)0)
+#else
+#define check(expr) do { if (!(expr)) { std::fprintf(stderr, "check failed: %s (%s:%d)\n", #expr, __FILE__, __LINE__); std::abort(); } } while (false)
+#endif
+
+
+template<typename T>
+struct TIntVector2
+{
+	T X{};
+	T Y{};
+
+	bool operator==(const TIntVector2& other) const { return X == other.X && Y == other.Y; }
+	bool operator!=(const TIntVector2& other) const { return false == (*this == other); }
+};
+
+typedef TIntVector2<uint32> FUint32Vector2;
+typedef TIntVector2<int32> FInt32Vector2;
+
+
+struct FMath
+{
+	template<typename T>
+	static constexpr T Min(const T a, const T b) { return (a < b) ? a : b; }
+
+	template<typename T>
+	static constexpr T Max(const T a, const T b) { return (a < b) ? b : a; }
+
+	static uint32 FloorLog2(uint32 value)
+	{
+		uint32 log{};
+		while (value >>= 1U) {
+			++log;
+		}
+		return log;
+	}
+
+	static uint32 RoundUpToPowerOfTwo(const uint32 value)
+	{
+		return (value <= 1U) ? 1U : (1U << (FloorLog2(value - 1U) + 1U));
+	}
+
+	/*
+	* Inclusive on both ends like the engine version. Seeded with a 
+	* fixed value so that benchmark runs are repeatable.
+	*/
+	static int32 RandRange(const int32 min, const int32 max)
+	{
+		static std::mt19937 generator{ 0x2D3A2E5U };
+		return std::uniform_int_distribution<int32>{ min, max }(generator);
+	}
+};
+
+
+struct FPlatformTime
+{
+	static uint64 Cycles64()
+	{
+		return (uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static double ToSeconds64(const uint64 cycles)
+	{
+		return (double)cycles * 1e-9;
+	}
+};
+
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Templates/SharedPointer.h"
+#include "Templates/Function.h"
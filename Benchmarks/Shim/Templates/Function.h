@@ -0,0 +1,9 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <functional>
+
+template<typename FunctionType>
+using TFunction = std::function<FunctionType>;
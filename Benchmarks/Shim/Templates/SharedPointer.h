@@ -0,0 +1,44 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <memory>
+
+enum class ESPMode : uint8
+{
+	NotThreadSafe,
+	ThreadSafe
+};
+
+/*
+* std::shared_ptr always counts atomically, which matches ESPMode::ThreadSafe.
+*/
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe>
+class TSharedPtr
+{
+public:
+
+	TSharedPtr() = default;
+	explicit TSharedPtr(std::shared_ptr<T>&& pointer) : _pointer(std::move(pointer)) {}
+
+	bool IsValid() const { return nullptr != _pointer; }
+
+	bool IsUnique() const { return 1 == _pointer.use_count(); }
+
+	int32 GetSharedReferenceCount() const { return (int32)_pointer.use_count(); }
+
+	T* Get() const { return _pointer.get(); }
+	T* operator->() const { check(IsValid()); return _pointer.get(); }
+	T& operator*() const { check(IsValid()); return *_pointer; }
+
+private:
+
+	std::shared_ptr<T> _pointer{};
+};
+
+template<typename T, ESPMode Mode = ESPMode::ThreadSafe, typename... ArgTypes>
+TSharedPtr<T, Mode> MakeShared(ArgTypes&&... args)
+{
+	return TSharedPtr<T, Mode>(std::make_shared<T>(std::forward<ArgTypes>(args)...));
+}
@@ -7,6 +7,7 @@
 
 typedef uint32 u32;
 typedef uint8 u8;
+typedef uint64 u64;
 typedef FUint32Vector2 TileCoordinate;
 
 /*
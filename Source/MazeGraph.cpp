@@ -2,6 +2,8 @@
 
 
 #include "MazeGraph.h"
+#include "ReservationTable.h"
+#include "PathRandomStream.h"
 #include "Algo/Reverse.h"
 
 
@@ -22,6 +24,72 @@ void MazeGraph::ConnectedMazeNodesToSingleNode::AddNode(const TileCoordinate nod
 	++size;
 }
 
+void MazeGraph::ConnectedMazeNodesToSingleNode::RemoveNode(const TileCoordinate nodeCoord, const u32 tilemapWidth)
+{
+	const u32 nodeIndex = nodeCoord.Y * tilemapWidth + nodeCoord.X;
+	for (u32 i = 0U; i < size; ++i) {
+		if (nodeIndex == connectedNodes[i]) {
+			--size;
+			connectedNodes[i] = connectedNodes[size];
+			connectedNodes[size] = std::numeric_limits<u32>::max();
+			return;
+		}
+	}
+}
+
+bool MazeGraph::ConnectedMazeNodesToSingleNode::HasSameNodesAs(const ConnectedMazeNodesToSingleNode& other) const
+{
+	if (size != other.size) { return false; }
+
+	for (u32 i = 0U; i < size; ++i) {
+		bool found{ false };
+		for (u32 j = 0U; j < other.size; ++j) {
+			if (connectedNodes[i] == other.connectedNodes[j]) {
+				found = true;
+				break;
+			}
+		}
+		if (false == found) { return false; }
+	}
+
+	return true;
+}
+
+template<bool bHasEdgeModifications>
+const MazeGraph::ConnectedMazeNodesToSingleNode& MazeGraph::SearchView<bHasEdgeModifications>::GetConnectedNodes(const u32 vertexNumber) const
+{
+	const u32 adjListIndex = indicesToVertices[vertexNumber];
+
+	if constexpr (bHasEdgeModifications) {
+		const u32 filterBitIndex = adjListIndex & (NumModifiedVertexFilterBits - 1U);
+		if (0U != (modifiedVertexFilter[filterBitIndex / 64U] & (1ULL << (filterBitIndex % 64U)))) {
+			if (const auto* modifiedConnectedNodes = edgeModifications->Find(adjListIndex)) {
+				return *modifiedConnectedNodes;
+			}
+		}
+	}
+
+	return adjList[adjListIndex];
+}
+
+template<bool bHasEdgeModifications>
+bool MazeGraph::SearchView<bHasEdgeModifications>::VertexVisitedBefore(const u32 vertexNumber) const
+{
+	return visitStamp == visitStamps[indicesToVertices[vertexNumber]];
+}
+
+template<bool bHasEdgeModifications>
+void MazeGraph::SearchView<bHasEdgeModifications>::MarkVertexAsVisited(const u32 vertexNumber) const
+{
+	visitStamps[indicesToVertices[vertexNumber]] = visitStamp;
+}
+
+template<bool bHasEdgeModifications>
+void MazeGraph::SearchView<bHasEdgeModifications>::UnmarkVertexAsVisited(const u32 vertexNumber) const
+{
+	visitStamps[indicesToVertices[vertexNumber]] = 0U;
+}
+
 
 
 void MazeGraph::Init(const u32 tileMapWidth, const u32 tileMapHeight)
@@ -31,40 +99,45 @@ void MazeGraph::Init(const u32 tileMapWidth, const u32 tileMapHeight)
 
 	constexpr u32 totalNumDirections = 4;
 
-	_adjList.Empty();
-	_visited.Empty();
-	_defaultVisited.Empty();
-	_tree.Empty();
+	//Always start from a fresh block so that other copies still sharing the old one are left untouched.
+	_staticGraph = MakeShared<StaticGraph, ESPMode::ThreadSafe>();
+	_edgeModifications.Empty();
+	_numTilesWithCost = 0U;
 
-	_adjList.Reserve(64U);
-	_visited.Reserve(64U);
-	_defaultVisited.Reserve(64U);
-	_tree.Reserve(256U);
+	_staticGraph->adjList.Reserve(64U);
 
 
 	const auto totalNumTiles = tilemapWidth * tilemapHeight;
-	_indicesToVertices.SetNumUninitialized(totalNumTiles, EAllowShrinking::Yes);
+	auto& indicesToVertices = _staticGraph->indicesToVertices;
+	indicesToVertices.SetNumUninitialized(totalNumTiles, EAllowShrinking::Yes);
 
-	for (size_t i = 0U; i < _indicesToVertices.Num(); ++i) {
-		_indicesToVertices[i] = std::numeric_limits<u32>::max();
+	for (size_t i = 0U; i < indicesToVertices.Num(); ++i) {
+		indicesToVertices[i] = std::numeric_limits<u32>::max();
 	}
 
-	_currentAdjListIndex = 0U;
+	_staticGraph->currentAdjListIndex = 0U;
+
+	MAZEGRAPH_STATS_ONLY(_stats.Reset());
 }
 
 
 u32 MazeGraph::GetTotalNumVertices() const
 {
-	return (u32)_adjList.Num();
+	return (u32)_staticGraph->adjList.Num();
 }
 
 u32 MazeGraph::GetTotalNumEdges() const
 {
 	u32 totalNumEdges{};
-	for (const auto& connectedNodes : _adjList) {
+	for (const auto& connectedNodes : _staticGraph->adjList) {
 		totalNumEdges += connectedNodes.size;
 	}
 
+	for (const auto& modification : _edgeModifications) {
+		totalNumEdges -= _staticGraph->adjList[modification.Key].size;
+		totalNumEdges += modification.Value.size;
+	}
+
 	return totalNumEdges / 2U;
 }
 
@@ -73,44 +146,139 @@ void MazeGraph::AddEdge(const TileCoordinate v, const TileCoordinate w)
 {
 	if (v.X < tilemapWidth && v.Y < tilemapHeight && w.X < tilemapWidth && w.Y < tilemapHeight) [[likely]] {
 
+		auto& staticGraph = GetStaticGraphForWriting();
+
 		const u32 vertexIndexV = GetVertexNumberFromTileCoord(v);
 		const u32 vertexIndexW = GetVertexNumberFromTileCoord(w);
 
-		const u32 indexOfVertexIndexV = _indicesToVertices[vertexIndexV];
-		const u32 indexOfVertexIndexW = _indicesToVertices[vertexIndexW];
+		const u32 indexOfVertexIndexV = staticGraph.indicesToVertices[vertexIndexV];
+		const u32 indexOfVertexIndexW = staticGraph.indicesToVertices[vertexIndexW];
 
 		if (std::numeric_limits<u32>::max() == indexOfVertexIndexV) {
 			ConnectedMazeNodesToSingleNode connectedNodesV{};
 			connectedNodesV.AddNode(w, tilemapWidth);
-			_adjList.Add(connectedNodesV);
-			_visited.Add(false);
-			_defaultVisited.Add(false);
-			_indicesToVertices[vertexIndexV] = _currentAdjListIndex;
-			++_currentAdjListIndex;
+			staticGraph.adjList.Add(connectedNodesV);
+			staticGraph.indicesToVertices[vertexIndexV] = staticGraph.currentAdjListIndex;
+			++staticGraph.currentAdjListIndex;
 		}
 		else {
-			auto& connectedNodesV = _adjList[indexOfVertexIndexV];
+			auto& connectedNodesV = staticGraph.adjList[indexOfVertexIndexV];
 			connectedNodesV.AddNode(w, tilemapWidth);
+			if (auto* modifiedConnectedNodesV = _edgeModifications.Find(indexOfVertexIndexV)) {
+				modifiedConnectedNodesV->AddNode(w, tilemapWidth);
+				DiscardModificationIfSameAsStaticGraph(v);
+			}
 		}
 
 
 		if (std::numeric_limits<u32>::max() == indexOfVertexIndexW) {
 			ConnectedMazeNodesToSingleNode connectedNodesW{};
 			connectedNodesW.AddNode(v, tilemapWidth);
-			_adjList.Add(connectedNodesW);
-			_visited.Add(false);
-			_defaultVisited.Add(false);
-			_indicesToVertices[vertexIndexW] = _currentAdjListIndex;
-			++_currentAdjListIndex;
+			staticGraph.adjList.Add(connectedNodesW);
+			staticGraph.indicesToVertices[vertexIndexW] = staticGraph.currentAdjListIndex;
+			++staticGraph.currentAdjListIndex;
 		}
 		else {
-			auto& connectedNodesW = _adjList[indexOfVertexIndexW];
+			auto& connectedNodesW = staticGraph.adjList[indexOfVertexIndexW];
 			connectedNodesW.AddNode(v, tilemapWidth);
+			if (auto* modifiedConnectedNodesW = _edgeModifications.Find(indexOfVertexIndexW)) {
+				modifiedConnectedNodesW->AddNode(v, tilemapWidth);
+				DiscardModificationIfSameAsStaticGraph(w);
+			}
 		}
 		
 	}
 }
 
+void MazeGraph::OpenEdge(const TileCoordinate v, const TileCoordinate w)
+{
+	if (false == IsVertexInStaticGraph(v) || false == IsVertexInStaticGraph(w) || v == w || IsAdjacent(v, w)) { return; }
+
+	//Adding the edge to only one of the vertices would make it one way.
+	const auto& connectedNodesV = GetConnectedNodeToRequestedVertexNumber(GetVertexNumberFromTileCoord(v));
+	const auto& connectedNodesW = GetConnectedNodeToRequestedVertexNumber(GetVertexNumberFromTileCoord(w));
+	if (connectedNodesV.connectedNodes.Num() == connectedNodesV.size || connectedNodesW.connectedNodes.Num() == connectedNodesW.size) { return; }
+
+	GetModifiableConnectedNodes(v).AddNode(w, tilemapWidth);
+	DiscardModificationIfSameAsStaticGraph(v);
+
+	GetModifiableConnectedNodes(w).AddNode(v, tilemapWidth);
+	DiscardModificationIfSameAsStaticGraph(w);
+}
+
+void MazeGraph::CloseEdge(const TileCoordinate v, const TileCoordinate w)
+{
+	if (false == IsVertexInStaticGraph(v) || false == IsVertexInStaticGraph(w)) { return; }
+
+	GetModifiableConnectedNodes(v).RemoveNode(w, tilemapWidth);
+	DiscardModificationIfSameAsStaticGraph(v);
+
+	GetModifiableConnectedNodes(w).RemoveNode(v, tilemapWidth);
+	DiscardModificationIfSameAsStaticGraph(w);
+}
+
+void MazeGraph::ClearEdgeModifications()
+{
+	TMap<u32, ConnectedMazeNodesToSingleNode> tileCostModifications{};
+	for (const auto& modification : _edgeModifications) {
+		const auto& staticConnectedNodes = _staticGraph->adjList[modification.Key];
+		if (staticConnectedNodes.cost != modification.Value.cost) {
+			auto& connectedNodes = tileCostModifications.Add(modification.Key, staticConnectedNodes);
+			connectedNodes.cost = modification.Value.cost;
+		}
+	}
+
+	_edgeModifications = std::move(tileCostModifications);
+}
+
+u32 MazeGraph::GetTotalNumEdgeModifications() const
+{
+	u32 totalNumEdgeModifications{};
+	for (const auto& modification : _edgeModifications) {
+		if (false == modification.Value.HasSameNodesAs(_staticGraph->adjList[modification.Key])) {
+			++totalNumEdgeModifications;
+		}
+	}
+
+	return totalNumEdgeModifications;
+}
+
+void MazeGraph::SetTileCost(const TileCoordinate tileCoord, const u8 cost)
+{
+	const u8 newCost = FMath::Max<u8>(cost, 1U);
+	if (false == IsVertexInStaticGraph(tileCoord)) { return; }
+
+	const u8 oldCost = GetTileCost(tileCoord);
+	if (oldCost == newCost) { return; }
+
+	if (1U < oldCost) {
+		--_numTilesWithCost;
+	}
+	if (1U < newCost) {
+		++_numTilesWithCost;
+	}
+
+	//Copying the whole shared block for one tile would defeat sharing it, so a shared graph keeps the cost in its overlay.
+	if (false == _staticGraph.IsUnique()) {
+		GetModifiableConnectedNodes(tileCoord).cost = newCost;
+		DiscardModificationIfSameAsStaticGraph(tileCoord);
+		return;
+	}
+
+	const u32 adjListIndex = _staticGraph->indicesToVertices[GetVertexNumberFromTileCoord(tileCoord)];
+	_staticGraph->adjList[adjListIndex].cost = newCost;
+
+	if (auto* modifiedConnectedNodes = _edgeModifications.Find(adjListIndex)) {
+		modifiedConnectedNodes->cost = newCost;
+		DiscardModificationIfSameAsStaticGraph(tileCoord);
+	}
+}
+
+u8 MazeGraph::GetTileCost(const TileCoordinate tileCoord) const
+{
+	return GetConnectedNodeToRequestedVertexNumber(GetVertexNumberFromTileCoord(tileCoord)).cost;
+}
+
 
 TArrayTilesInline16 MazeGraph::GetAllAdjacentVertices(const TileCoordinate tileCoord) const
 {
@@ -162,43 +330,59 @@ bool MazeGraph::IsAdjacent(const TileCoordinate v, const TileCoordinate w) const
 
 TArrayTilesInline16 MazeGraph::GeneratePathWithFixedLength(const TileCoordinate source, const u32 length) const
 {
-	memcpy(_visited.GetData(), _defaultVisited.GetData(), _visited.Num() * sizeof(bool));
-	_queueWithLength.Empty();
-	_tree.SetNum(0U, EAllowShrinking::No);
+	if (0 == _edgeModifications.Num()) [[likely]] {
+		return GeneratePathWithFixedLength(BeginSearch<false>(), source, length);
+	}
+
+	return GeneratePathWithFixedLength(BeginSearch<true>(), source, length);
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GeneratePathWithFixedLength(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const u32 length) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.queueWithLength.Empty();
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
 	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, MazeGraphQueryType::PathWithFixedLength));
 
 	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
 
-	_queueWithLength.Enqueue({ nodeNumberSource, 0U});
+	scratch.queueWithLength.Enqueue({ nodeNumberSource, 0U});
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
 	TraversedNode targetTraversedNode{};
 	targetTraversedNode.nodeNumber = nodeNumberSource;
-	_tree.Add(targetTraversedNode);
-	MarkVertexAsVisited(nodeNumberSource);
+	scratch.tree.Add(targetTraversedNode);
+	searchView.MarkVertexAsVisited(nodeNumberSource);
 
 	if (0U == length) {
 		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
-		return path; 
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
+		return path;
 	}
 
 
 	u32 currentParentIndex{};
 	u32 currentLongestLengthEndNode{};
-	while (false == _queueWithLength.IsEmpty()) {
+	while (false == scratch.queueWithLength.IsEmpty()) {
 
 		FUint32Vector2 currentNodeNumber{};
-		_queueWithLength.Dequeue(currentNodeNumber);
+		scratch.queueWithLength.Dequeue(currentNodeNumber);
+		MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
 
 		if (length == currentNodeNumber.Y) { break; }
 
-		const auto& connectedNodes = GetConnectedNodeToRequestedVertexNumber(currentNodeNumber.X);
+		const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber.X);
 		for (size_t i = 0U; i < connectedNodes.size; ++i) {
 
 			const auto currentConnectedNodeNumber = connectedNodes.connectedNodes[i];
 
-			if (false == VertexVisitedBefore(currentConnectedNodeNumber)) {
-				_queueWithLength.Enqueue({ currentConnectedNodeNumber, currentNodeNumber.Y + 1U});
-				_tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
-				MarkVertexAsVisited(currentConnectedNodeNumber);
+			if (false == searchView.VertexVisitedBefore(currentConnectedNodeNumber)) {
+				scratch.queueWithLength.Enqueue({ currentConnectedNodeNumber, currentNodeNumber.Y + 1U});
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+				scratch.tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
+				searchView.MarkVertexAsVisited(currentConnectedNodeNumber);
 				++currentLongestLengthEndNode;
 			}
 
@@ -207,54 +391,70 @@ TArrayTilesInline16 MazeGraph::GeneratePathWithFixedLength(const TileCoordinate
 		++currentParentIndex;
 	}
 
-	u32 tempNodeNumber = _tree[currentLongestLengthEndNode].nodeNumber;
-	u32 tempParentNodeNumber = _tree[currentLongestLengthEndNode].parentNodeIndex;
+	u32 tempNodeNumber = scratch.tree[currentLongestLengthEndNode].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[currentLongestLengthEndNode].parentNodeIndex;
 	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	while (nodeNumberSource != tempNodeNumber) {
 
 		if (std::numeric_limits<u32>::max() == tempParentNodeNumber) {
 			break;
 		}
-		tempNodeNumber = _tree[tempParentNodeNumber].nodeNumber;
-		tempParentNodeNumber = _tree[tempParentNodeNumber].parentNodeIndex;
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
 
 		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	}
 
 	Algo::Reverse(path);
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 	return path;
 }
 
 TArrayTilesInline16 MazeGraph::GeneratePathAlongDirection(const TileCoordinate source
 	, const FInt32Vector2 direction, const u32 maxLength) const
 {
-	memcpy(_visited.GetData(), _defaultVisited.GetData(), _visited.Num() * sizeof(bool));
-	_queue.Empty();
-	_tree.SetNum(0U, EAllowShrinking::No);
+	if (0 == _edgeModifications.Num()) [[likely]] {
+		return GeneratePathAlongDirection(BeginSearch<false>(), source, direction, maxLength);
+	}
+
+	return GeneratePathAlongDirection(BeginSearch<true>(), source, direction, maxLength);
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GeneratePathAlongDirection(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const FInt32Vector2 direction, const u32 maxLength) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.queue.Empty();
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
 	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, MazeGraphQueryType::PathAlongDirection));
 
 	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
 
-	_queue.Enqueue(nodeNumberSource);
+	scratch.queue.Enqueue(nodeNumberSource);
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
 	TraversedNode targetTraversedNode{};
 	targetTraversedNode.nodeNumber = nodeNumberSource;
-	_tree.Add(targetTraversedNode);
-	MarkVertexAsVisited(nodeNumberSource);
+	scratch.tree.Add(targetTraversedNode);
+	searchView.MarkVertexAsVisited(nodeNumberSource);
 
 
 	if (FInt32Vector2{} == direction) {
 		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 		return path;
 	}
 
 	u32 currentParentIndex{};
 	u32 currentLength{};
-	while (false == _queue.IsEmpty()) {
+	while (false == scratch.queue.IsEmpty()) {
 
 		u32 currentNodeNumber{};
-		_queue.Dequeue(currentNodeNumber);
+		scratch.queue.Dequeue(currentNodeNumber);
+		MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
 
-		const auto& connectedNodes = GetConnectedNodeToRequestedVertexNumber(currentNodeNumber);
+		const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber);
 
 		if (0U != connectedNodes.size) {
 			const u32 mostAlignedTileCoordIndex = FindMostAlignedTileCoordIndexAlongDirection(connectedNodes, currentNodeNumber, direction);
@@ -267,10 +467,11 @@ TArrayTilesInline16 MazeGraph::GeneratePathAlongDirection(const TileCoordinate s
 
 			const auto currentConnectedNodeNumber = connectedNodes.connectedNodes[mostAlignedTileCoordIndex];
 
-			if (false == VertexVisitedBefore(currentConnectedNodeNumber)) {
-				_queue.Enqueue(currentConnectedNodeNumber);
-				_tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
-				MarkVertexAsVisited(currentConnectedNodeNumber);
+			if (false == searchView.VertexVisitedBefore(currentConnectedNodeNumber)) {
+				scratch.queue.Enqueue(currentConnectedNodeNumber);
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+				scratch.tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
+				searchView.MarkVertexAsVisited(currentConnectedNodeNumber);
 				++currentParentIndex;
 				++currentLength;
 			}
@@ -279,77 +480,104 @@ TArrayTilesInline16 MazeGraph::GeneratePathAlongDirection(const TileCoordinate s
 
 	}
 
-	u32 tempNodeNumber = _tree[currentParentIndex].nodeNumber;
-	u32 tempParentNodeNumber = _tree[currentParentIndex].parentNodeIndex;
+	u32 tempNodeNumber = scratch.tree[currentParentIndex].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[currentParentIndex].parentNodeIndex;
 	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	while (nodeNumberSource != tempNodeNumber) {
 
 		if (std::numeric_limits<u32>::max() == tempParentNodeNumber) {
 			break;
 		}
-		tempNodeNumber = _tree[tempParentNodeNumber].nodeNumber;
-		tempParentNodeNumber = _tree[tempParentNodeNumber].parentNodeIndex;
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
 
 		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	}
 
 	Algo::Reverse(path);
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 	return path;
 }
 
 TArrayTilesInline16 MazeGraph::GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(const TileCoordinate source
 	,const TileCoordinate target, const TileCoordinate tileToAvoid) const
 {
-	memcpy(_visited.GetData(), _defaultVisited.GetData(), _visited.Num() * sizeof(bool));
-	_queue.Empty();
-	_tree.SetNum(0U, EAllowShrinking::No);
+	if (0U != _numTilesWithCost) {
+		const u32 nodeNumberToAvoid = GetVertexNumberFromTileCoord(tileToAvoid);
+		if (0 == _edgeModifications.Num()) [[likely]] {
+			return GenerateCheapestPathFromSourceToTarget(BeginSearch<false>(), source, target, MazeGraphQueryType::PathNotGoingThroughTile, nodeNumberToAvoid);
+		}
+
+		return GenerateCheapestPathFromSourceToTarget(BeginSearch<true>(), source, target, MazeGraphQueryType::PathNotGoingThroughTile, nodeNumberToAvoid);
+	}
+
+	if (0 == _edgeModifications.Num()) [[likely]] {
+		return GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(BeginSearch<false>(), source, target, tileToAvoid);
+	}
+
+	return GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(BeginSearch<true>(), source, target, tileToAvoid);
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const TileCoordinate target, const TileCoordinate tileToAvoid) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.queue.Empty();
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
 	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, MazeGraphQueryType::PathNotGoingThroughTile));
 
 	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
 	const auto nodeNumberTileToAvoid = GetVertexNumberFromTileCoord(tileToAvoid);
 	const auto nodeNumberTarget = GetVertexNumberFromTileCoord(target);
 
-	_queue.Enqueue(nodeNumberTarget);
+	scratch.queue.Enqueue(nodeNumberTarget);
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
 	TraversedNode targetTraversedNode{};
 	targetTraversedNode.nodeNumber = nodeNumberTarget;
-	_tree.Add(targetTraversedNode);
-	MarkVertexAsVisited(nodeNumberTarget);
+	scratch.tree.Add(targetTraversedNode);
+	searchView.MarkVertexAsVisited(nodeNumberTarget);
 
 	if (source == tileToAvoid || source == target || tileToAvoid == target) {
 		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 		return path;
 	}
 
 	u32 currentParentIndex{};
-	while (false == _queue.IsEmpty()) {
+	while (false == scratch.queue.IsEmpty()) {
 
 		u32 currentNodeNumber{};
-		_queue.Dequeue(currentNodeNumber);
+		scratch.queue.Dequeue(currentNodeNumber);
+		MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
 
 		if (currentNodeNumber == nodeNumberSource) { break; }
 
-		const auto& connectedNodes = GetConnectedNodeToRequestedVertexNumber(currentNodeNumber);
+		const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber);
 		for (size_t i = 0U; i < connectedNodes.size; ++i) {
 
 			const auto currentConnectedNodeNumber = connectedNodes.connectedNodes[i];
 
-			if (currentConnectedNodeNumber != nodeNumberTileToAvoid && false == VertexVisitedBefore(currentConnectedNodeNumber)) {
-				_queue.Enqueue(currentConnectedNodeNumber);
-				_tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
-				MarkVertexAsVisited(currentConnectedNodeNumber);
+			if (currentConnectedNodeNumber != nodeNumberTileToAvoid && false == searchView.VertexVisitedBefore(currentConnectedNodeNumber)) {
+				scratch.queue.Enqueue(currentConnectedNodeNumber);
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+				scratch.tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
+				searchView.MarkVertexAsVisited(currentConnectedNodeNumber);
 			}
 
 		}
 		++currentParentIndex;
 	}
 
-	if (_tree.Num() == currentParentIndex) {
+	if (scratch.tree.Num() == currentParentIndex) {
 		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 		return path;
 	}
 
-	u32 tempNodeNumber = _tree[currentParentIndex].nodeNumber;
-	u32 tempParentNodeNumber = _tree[currentParentIndex].parentNodeIndex;
+	u32 tempNodeNumber = scratch.tree[currentParentIndex].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[currentParentIndex].parentNodeIndex;
 	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	while (nodeNumberTarget != tempNodeNumber) {
 
@@ -357,56 +585,92 @@ TArrayTilesInline16 MazeGraph::GeneratePathBetweenTwoTilesNotGoingThroughSpecifi
 			break;
 		}
 
-		tempNodeNumber = _tree[tempParentNodeNumber].nodeNumber;
-		tempParentNodeNumber = _tree[tempParentNodeNumber].parentNodeIndex;
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
 
 		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	}
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 	return path;
 }
 
 
 TArrayTilesInline16 MazeGraph::GenerateShortestPathFromSourceToTarget(const TileCoordinate source, const TileCoordinate target) const
 {
-	memcpy(_visited.GetData(), _defaultVisited.GetData(), _visited.Num() * sizeof(bool));
-	_queue.Empty();
-	_tree.SetNum(0U, EAllowShrinking::No);
+	return GenerateShortestPathFromSourceToTarget(source, target, MazeGraphQueryType::ShortestPath);
+}
+
+TArrayTilesInline16 MazeGraph::GenerateShortestPathFromSourceToTarget(const TileCoordinate source, const TileCoordinate target
+	, const MazeGraphQueryType queryType) const
+{
+	const bool hasTileCosts = (0U != _numTilesWithCost);
+
+	//Weighted searches are recorded as CheapestPath unless they are part of another query.
+	const MazeGraphQueryType cheapestQueryType = (MazeGraphQueryType::ShortestPath == queryType) ? MazeGraphQueryType::CheapestPath : queryType;
+
+	if (0 == _edgeModifications.Num()) [[likely]] {
+		return hasTileCosts ? GenerateCheapestPathFromSourceToTarget(BeginSearch<false>(), source, target, cheapestQueryType, std::numeric_limits<u32>::max())
+			: GenerateShortestPathFromSourceToTarget(BeginSearch<false>(), source, target, queryType);
+	}
+
+	return hasTileCosts ? GenerateCheapestPathFromSourceToTarget(BeginSearch<true>(), source, target, cheapestQueryType, std::numeric_limits<u32>::max())
+		: GenerateShortestPathFromSourceToTarget(BeginSearch<true>(), source, target, queryType);
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GenerateShortestPathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const TileCoordinate target, [[maybe_unused]] const MazeGraphQueryType queryType) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.queue.Empty();
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
 	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, queryType));
 
 	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
 	const auto nodeNumberTarget = GetVertexNumberFromTileCoord(target);
 
-	_queue.Enqueue(nodeNumberTarget);
+	scratch.queue.Enqueue(nodeNumberTarget);
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
 	TraversedNode targetTraversedNode{};
 	targetTraversedNode.nodeNumber = nodeNumberTarget;
-	_tree.Add(targetTraversedNode);
-	MarkVertexAsVisited(nodeNumberTarget);
+	scratch.tree.Add(targetTraversedNode);
+	searchView.MarkVertexAsVisited(nodeNumberTarget);
 
 	u32 currentParentIndex{};
-	while (false == _queue.IsEmpty()) {
+	while (false == scratch.queue.IsEmpty()) {
 
 		u32 currentNodeNumber{};
-		_queue.Dequeue(currentNodeNumber);
+		scratch.queue.Dequeue(currentNodeNumber);
+		MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
 
 		if (currentNodeNumber == nodeNumberSource) { break; }
 
-		const auto& connectedNodes = GetConnectedNodeToRequestedVertexNumber(currentNodeNumber);
+		const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber);
 		for (size_t i = 0U; i < connectedNodes.size; ++i) {
 
 			const auto currentConnectedNodeNumber = connectedNodes.connectedNodes[i];
 
-			if (false == VertexVisitedBefore(currentConnectedNodeNumber)) {
-				_queue.Enqueue(currentConnectedNodeNumber);
-				_tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
-				MarkVertexAsVisited(currentConnectedNodeNumber);
+			if (false == searchView.VertexVisitedBefore(currentConnectedNodeNumber)) {
+				scratch.queue.Enqueue(currentConnectedNodeNumber);
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+				scratch.tree.Add(TraversedNode{ currentConnectedNodeNumber, currentParentIndex });
+				searchView.MarkVertexAsVisited(currentConnectedNodeNumber);
 			}
 
 		}
 		++currentParentIndex;
 	}
 
-	u32 tempNodeNumber = _tree[currentParentIndex].nodeNumber;
-	u32 tempParentNodeNumber = _tree[currentParentIndex].parentNodeIndex;
+	//Source can only be unreachable when edges were closed with CloseEdge().
+	if ((u32)scratch.tree.Num() == currentParentIndex) [[unlikely]] {
+		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
+		return path;
+	}
+
+	u32 tempNodeNumber = scratch.tree[currentParentIndex].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[currentParentIndex].parentNodeIndex;
 	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	while (nodeNumberTarget != tempNodeNumber) {
 
@@ -414,12 +678,306 @@ TArrayTilesInline16 MazeGraph::GenerateShortestPathFromSourceToTarget(const Tile
 			break;
 		}
 
-		tempNodeNumber = _tree[tempParentNodeNumber].nodeNumber;
-		tempParentNodeNumber = _tree[tempParentNodeNumber].parentNodeIndex;
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
 
 		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
 	}
 	
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
+	return path;
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GenerateCheapestPathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const TileCoordinate target, [[maybe_unused]] const MazeGraphQueryType queryType, const u32 nodeNumberToAvoid) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
+	if (0 == scratch.costBuckets.Num()) [[unlikely]] {
+		scratch.costBuckets.SetNum(NumCostBuckets);
+	}
+	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, queryType, true));
+
+	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
+	const auto nodeNumberTarget = GetVertexNumberFromTileCoord(target);
+
+	//Marking the tile to avoid as visited blocks it. When it is the source or the target no path is found and only the source is returned.
+	if (std::numeric_limits<u32>::max() != nodeNumberToAvoid && std::numeric_limits<u32>::max() != searchView.indicesToVertices[nodeNumberToAvoid]) {
+		searchView.MarkVertexAsVisited(nodeNumberToAvoid);
+	}
+
+	/*
+	* The search starts from the target like the unweighted one, so stepping from 
+	* a vertex to its adjacent one costs as much as entering the former when
+	* walking the path from the source. A vertex can be queued once per adjacent 
+	* vertex and only the first, cheapest, time it is dequeued counts.
+	*/
+	TraversedNode targetTraversedNode{};
+	targetTraversedNode.nodeNumber = nodeNumberTarget;
+	scratch.tree.Add(targetTraversedNode);
+	scratch.costBuckets[0].Add(0U);
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+
+	u32 numQueuedNodes{ 1U };
+	u32 currentCost{};
+	u32 sourceTreeIndex{ std::numeric_limits<u32>::max() };
+	while (0U != numQueuedNodes) {
+
+		auto& currentBucket = scratch.costBuckets[currentCost & (NumCostBuckets - 1U)];
+		if (0 == currentBucket.Num()) {
+			++currentCost;
+			continue;
+		}
+
+		const u32 currentTreeIndex = currentBucket.Pop(EAllowShrinking::No);
+		--numQueuedNodes;
+
+		const u32 currentNodeNumber = scratch.tree[currentTreeIndex].nodeNumber;
+		if (searchView.VertexVisitedBefore(currentNodeNumber)) {
+			MAZEGRAPH_STATS_ONLY(recorder.OnStaleNodeDequeued());
+			continue;
+		}
+		searchView.MarkVertexAsVisited(currentNodeNumber);
+		MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
+
+		if (currentNodeNumber == nodeNumberSource) {
+			sourceTreeIndex = currentTreeIndex;
+			break;
+		}
+
+		const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber);
+		auto& nextBucket = scratch.costBuckets[(currentCost + connectedNodes.cost) & (NumCostBuckets - 1U)];
+		for (u32 i = 0U; i < connectedNodes.size; ++i) {
+
+			const auto currentConnectedNodeNumber = connectedNodes.connectedNodes[i];
+
+			if (false == searchView.VertexVisitedBefore(currentConnectedNodeNumber)) {
+				nextBucket.Add((u32)scratch.tree.Num());
+				scratch.tree.Add(TraversedNode{ currentConnectedNodeNumber, currentTreeIndex });
+				++numQueuedNodes;
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+			}
+		}
+	}
+
+	if (0U != numQueuedNodes) {
+		for (auto& costBucket : scratch.costBuckets) {
+			costBucket.SetNum(0, EAllowShrinking::No);
+		}
+	}
+
+	//Source can only be unreachable when edges were closed with CloseEdge().
+	if (std::numeric_limits<u32>::max() == sourceTreeIndex) [[unlikely]] {
+		path.Add(GetTileCoordFromVertexNumber(nodeNumberSource));
+		MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
+		return path;
+	}
+
+	u32 tempNodeNumber = scratch.tree[sourceTreeIndex].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[sourceTreeIndex].parentNodeIndex;
+	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
+	while (nodeNumberTarget != tempNodeNumber) {
+
+		if (std::numeric_limits<u32>::max() == tempParentNodeNumber) [[unlikely]] {
+			break;
+		}
+
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
+
+		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
+	}
+
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
+	return path;
+}
+
+TArrayTilesInline16 MazeGraph::GenerateRandomWalkFromSource(const TileCoordinate source
+	, PathRandomStream& randomStream, const u32 minLength, const u32 maxLength) const
+{
+	check(minLength <= maxLength && maxLength - minLength < std::numeric_limits<u32>::max());
+
+	TArrayTilesInline16 path{};
+
+	const u32 length = minLength + randomStream.NextBounded(maxLength - minLength + 1U);
+	path.Reserve(length + 1U);
+	path.Add(source);
+
+	u32 previousNodeNumber{ std::numeric_limits<u32>::max() };
+	u32 currentNodeNumber = GetVertexNumberFromTileCoord(source);
+	for (u32 step = 0U; step < length; ++step) {
+
+		const auto& connectedNodes = GetConnectedNodeToRequestedVertexNumber(currentNodeNumber);
+		if (0U == connectedNodes.size) [[unlikely]] { break; }
+
+		TStaticArray<u32, 4> candidateNodeNumbers{};
+		u32 numCandidates{};
+		for (u32 i = 0U; i < connectedNodes.size; ++i) {
+			if (previousNodeNumber != connectedNodes.connectedNodes[i]) {
+				candidateNodeNumbers[numCandidates] = connectedNodes.connectedNodes[i];
+				++numCandidates;
+			}
+		}
+
+		//Only a dead end leaves no candidate, where the walk has to turn back.
+		const u32 nextNodeNumber = (0U == numCandidates) ? previousNodeNumber 
+			: candidateNodeNumbers[randomStream.NextBounded(numCandidates)];
+
+		previousNodeNumber = currentNodeNumber;
+		currentNodeNumber = nextNodeNumber;
+		path.Add(GetTileCoordFromVertexNumber(currentNodeNumber));
+	}
+
+	return path;
+}
+
+TArrayTilesInline16 MazeGraph::GenerateRandomPatrolFromSource(const TileCoordinate source
+	, PathRandomStream& randomStream, const u32 minLength, const u32 maxLength) const
+{
+	check(minLength <= maxLength);
+
+	TArrayTilesInline16 path = GenerateRandomWalkFromSource(source, randomStream, minLength / 2U + minLength % 2U, maxLength / 2U + maxLength % 2U);
+
+	const int32 numOutwardTiles = path.Num();
+	path.Reserve(2 * numOutwardTiles - 1);
+	for (int32 i = numOutwardTiles - 2; i >= 0; --i) {
+		const TileCoordinate tileCoord = path[i];
+		path.Add(tileCoord);
+	}
+
+	return path;
+}
+
+TArrayTilesInline16 MazeGraph::GenerateCooperativePathFromSourceToTarget(const TileCoordinate source
+	, const TileCoordinate target, const ReservationTable& reservations, const u32 startTick, const u32 windowLength) const
+{
+	TArrayTilesInline16 route{};
+	return GenerateCooperativePathFromSourceToTarget(source, target, reservations, startTick, windowLength, route);
+}
+
+TArrayTilesInline16 MazeGraph::GenerateCooperativePathFromSourceToTarget(const TileCoordinate source, const TileCoordinate target
+	, const ReservationTable& reservations, const u32 startTick, const u32 windowLength, TArrayTilesInline16& inOutRoute) const
+{
+	if (false == TrimRouteToSource(inOutRoute, source, target, windowLength)) {
+		inOutRoute = GenerateShortestPathFromSourceToTarget(source, target, MazeGraphQueryType::CooperativeRoute);
+	}
+
+	if (0 == _edgeModifications.Num()) [[likely]] {
+		return GenerateCooperativePathFromSourceToTarget(BeginSearch<false>(), source, inOutRoute, reservations, startTick, windowLength);
+	}
+
+	return GenerateCooperativePathFromSourceToTarget(BeginSearch<true>(), source, inOutRoute, reservations, startTick, windowLength);
+}
+
+template<bool bHasEdgeModifications>
+TArrayTilesInline16 MazeGraph::GenerateCooperativePathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+	, const TileCoordinate source, const TArrayTilesInline16& unconstrainedPath
+	, const ReservationTable& reservations, const u32 startTick, const u32 windowLength) const
+{
+	SearchScratch& scratch = *searchView.scratch;
+	scratch.tree.SetNum(0U, EAllowShrinking::No);
+	TArrayTilesInline16 path{};
+	MAZEGRAPH_STATS_ONLY(MazeGraphQueryRecorder recorder(_stats, MazeGraphQueryType::CooperativePath));
+
+	//The table only keeps the ticks counted from its own current tick, so the window must not plan past them.
+	check(startTick >= reservations.GetCurrentTick() && startTick - reservations.GetCurrentTick() < reservations.GetHorizon());
+	const u32 numTicks = FMath::Min(windowLength, reservations.GetCurrentTick() + reservations.GetHorizon() - 1U - startTick);
+	const u32 numReachablePathTiles = FMath::Min((u32)unconstrainedPath.Num(), numTicks + 1U);
+	const u32 lastPathIndex = (u32)unconstrainedPath.Num() - 1U;
+
+	scratch.windowPathIndices.Reset();
+	for (u32 i = 0U; i < numReachablePathTiles; ++i) {
+		scratch.windowPathIndices.Add(GetVertexNumberFromTileCoord(unconstrainedPath[i]), i);
+	}
+
+	const auto nodeNumberSource = GetVertexNumberFromTileCoord(source);
+
+	TraversedNode sourceTraversedNode{};
+	sourceTraversedNode.nodeNumber = nodeNumberSource;
+	scratch.tree.Add(sourceTraversedNode);
+	MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+
+	//Reservations of the source are the agent's own, made for the whole window before any agent was planned, so nobody else can be on it.
+	const auto isReservedByOthers = [&reservations, nodeNumberSource](const u32 nodeNumber, const u32 tick) {
+		return nodeNumberSource != nodeNumber && reservations.IsVertexReserved(nodeNumber, tick);
+	};
+
+	//The agent waits on the last tile of its path until the window ends, so that tile has to stay free.
+	const auto canWaitUntilWindowEnd = [&isReservedByOthers, startTick, numTicks](const u32 nodeNumber, const u32 tick) {
+		for (u32 waitTick = tick + 1U; waitTick <= numTicks; ++waitTick) {
+			if (isReservedByOthers(nodeNumber, startTick + waitTick)) { return false; }
+		}
+		return true;
+	};
+
+	/*
+	* Breadth first search over (tile, tick) where every layer of the tree is one tick. 
+	* Vertices are marked as visited only while their layer is being filled, 
+	* so the same tile can appear again at later ticks. Waiting on the source 
+	* until the window ends is always safe, so it is the plan to beat.
+	*/
+	u32 bestTreeIndex{};
+	u32 bestPathIndex{};
+	u32 layerStart{};
+	u32 layerEnd{ 1U };
+	for (u32 tick = 0U; tick < numTicks && layerStart != layerEnd && lastPathIndex != bestPathIndex; ++tick) {
+
+		const u32 nextTick = startTick + tick + 1U;
+		for (u32 treeIndex = layerStart; treeIndex < layerEnd && lastPathIndex != bestPathIndex; ++treeIndex) {
+
+			const u32 currentNodeNumber = scratch.tree[treeIndex].nodeNumber;
+			MAZEGRAPH_STATS_ONLY(recorder.OnNodeExpanded());
+
+			const auto& connectedNodes = searchView.GetConnectedNodes(currentNodeNumber);
+			for (u32 i = 0U; i <= connectedNodes.size; ++i) {
+
+				//The last candidate is waiting on the current tile.
+				const u32 candidateNodeNumber = (i < connectedNodes.size) ? connectedNodes.connectedNodes[i] : currentNodeNumber;
+
+				if (searchView.VertexVisitedBefore(candidateNodeNumber) || isReservedByOthers(candidateNodeNumber, nextTick)) { continue; }
+
+				if (candidateNodeNumber != currentNodeNumber && isReservedByOthers(candidateNodeNumber, nextTick - 1U)
+					&& isReservedByOthers(currentNodeNumber, nextTick)) {
+					continue;
+				}
+
+				searchView.MarkVertexAsVisited(candidateNodeNumber);
+				scratch.tree.Add(TraversedNode{ candidateNodeNumber, treeIndex });
+				MAZEGRAPH_STATS_ONLY(recorder.OnNodeEnqueued());
+
+				const u32* pathIndex = scratch.windowPathIndices.Find(candidateNodeNumber);
+				const bool isBetter = (nullptr != pathIndex) && (bestPathIndex < *pathIndex);
+				if (isBetter && canWaitUntilWindowEnd(candidateNodeNumber, tick + 1U)) {
+					bestPathIndex = *pathIndex;
+					bestTreeIndex = (u32)scratch.tree.Num() - 1U;
+					if (lastPathIndex == bestPathIndex) { break; }
+				}
+			}
+		}
+
+		const u32 nextLayerEnd = (u32)scratch.tree.Num();
+		for (u32 treeIndex = layerEnd; treeIndex < nextLayerEnd; ++treeIndex) {
+			searchView.UnmarkVertexAsVisited(scratch.tree[treeIndex].nodeNumber);
+		}
+		layerStart = layerEnd;
+		layerEnd = nextLayerEnd;
+	}
+
+	u32 tempNodeNumber = scratch.tree[bestTreeIndex].nodeNumber;
+	u32 tempParentNodeNumber = scratch.tree[bestTreeIndex].parentNodeIndex;
+	path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
+	while (std::numeric_limits<u32>::max() != tempParentNodeNumber) {
+
+		tempNodeNumber = scratch.tree[tempParentNodeNumber].nodeNumber;
+		tempParentNodeNumber = scratch.tree[tempParentNodeNumber].parentNodeIndex;
+
+		path.Add(GetTileCoordFromVertexNumber(tempNodeNumber));
+	}
+
+	Algo::Reverse(path);
+	MAZEGRAPH_STATS_ONLY(recorder.Finish(scratch.tree.Num(), path.Num()));
 	return path;
 }
 
@@ -435,6 +993,53 @@ TArrayTilesInline16 MazeGraph::GenerateNonTrivialRandomPathStartingFromSource(co
 }
 
 
+bool MazeGraph::TrimRouteToSource(TArrayTilesInline16& route, const TileCoordinate source, const TileCoordinate target, const u32 windowLength) const
+{
+	if (0 == route.Num() || target != route.Last()) { return false; }
+
+	const int32 sourceIndex = route.Find(source);
+	if (INDEX_NONE == sourceIndex) { return false; }
+
+	route.RemoveAt(0, sourceIndex, EAllowShrinking::No);
+
+	/*
+	* Closed edges or a graph rebuilt through Init() can break a route. Only the tiles the window 
+	* can reach are checked, so this stays as cheap as the window. The rest is checked once later 
+	* windows reach it.
+	*/
+	const int32 numCheckedTiles = (int32)(FMath::Min((u32)route.Num() - 1U, windowLength) + 1U);
+	for (int32 i = 0; i < numCheckedTiles; ++i) {
+		if (false == IsVertexInStaticGraph(route[i]) || (0 != i && false == IsAdjacent(route[i - 1], route[i]))) { return false; }
+	}
+
+	return true;
+}
+
+
+MazeGraphStatsSnapshot MazeGraph::GetStatsSnapshot() const
+{
+#if MAZEGRAPH_STATS
+	return _stats.GetSnapshot();
+#else
+	return MazeGraphStatsSnapshot{};
+#endif
+}
+
+void MazeGraph::ResetStats()
+{
+	MAZEGRAPH_STATS_ONLY(_stats.Reset());
+}
+
+void MazeGraph::SetQueryTraceSink(MazeGraphQueryTraceSink&& traceSink)
+{
+#if MAZEGRAPH_STATS
+	_stats.SetTraceSink(std::move(traceSink));
+#else
+	(void)traceSink;
+#endif
+}
+
+
 TileCoordinate MazeGraph::GetTileCoordFromVertexNumber(const u32 nodeNumber) const
 {
 	const auto y = nodeNumber / tilemapWidth;
@@ -451,31 +1056,112 @@ u32 MazeGraph::GetVertexNumberFromTileCoord(const TileCoordinate tileCoord) cons
 
 TileCoordinate MazeGraph::GetRandomTileCoordinate() const
 {
-	check(_adjList.Num() != 0);
+	const auto& adjList = _staticGraph->adjList;
+	check(adjList.Num() != 0);
 
-	const auto randomIndex = FMath::RandRange(0, _adjList.Num() - 1U);
+	const auto randomIndex = FMath::RandRange(0, adjList.Num() - 1U);
 
-	return GetTileCoordFromVertexNumber(_adjList[randomIndex].connectedNodes[0]);
+	return GetTileCoordFromVertexNumber(adjList[randomIndex].connectedNodes[0]);
 }
 
-MazeGraph::ConnectedMazeNodesToSingleNode& MazeGraph::GetConnectedNodeToRequestedVertexNumber(const u32 vertexNumber)
+const MazeGraph::ConnectedMazeNodesToSingleNode& MazeGraph::GetConnectedNodeToRequestedVertexNumber(const u32 vertexNumber) const
 {
-	return _adjList[_indicesToVertices[vertexNumber]];
+	const u32 adjListIndex = _staticGraph->indicesToVertices[vertexNumber];
+
+	if (0 != _edgeModifications.Num()) [[unlikely]] {
+		if (const auto* modifiedConnectedNodes = _edgeModifications.Find(adjListIndex)) {
+			return *modifiedConnectedNodes;
+		}
+	}
+
+	return _staticGraph->adjList[adjListIndex];
 }
 
-const MazeGraph::ConnectedMazeNodesToSingleNode& MazeGraph::GetConnectedNodeToRequestedVertexNumber(const u32 vertexNumber) const
+MazeGraph::StaticGraph& MazeGraph::GetStaticGraphForWriting()
+{
+	check(_staticGraph.IsValid());
+
+	if (false == _staticGraph.IsUnique()) {
+		_staticGraph = MakeShared<StaticGraph, ESPMode::ThreadSafe>(*_staticGraph);
+	}
+
+	return *_staticGraph;
+}
+
+bool MazeGraph::IsVertexInStaticGraph(const TileCoordinate tileCoord) const
+{
+	if (tileCoord.X >= tilemapWidth || tileCoord.Y >= tilemapHeight) [[unlikely]] { return false; }
+
+	return std::numeric_limits<u32>::max() != _staticGraph->indicesToVertices[GetVertexNumberFromTileCoord(tileCoord)];
+}
+
+MazeGraph::ConnectedMazeNodesToSingleNode& MazeGraph::GetModifiableConnectedNodes(const TileCoordinate tileCoord)
 {
-	return _adjList[_indicesToVertices[vertexNumber]];
+	check(IsVertexInStaticGraph(tileCoord));
+
+	const u32 adjListIndex = _staticGraph->indicesToVertices[GetVertexNumberFromTileCoord(tileCoord)];
+	return _edgeModifications.FindOrAdd(adjListIndex, _staticGraph->adjList[adjListIndex]);
 }
 
-bool MazeGraph::VertexVisitedBefore(const u32 vertexNumber) const
+void MazeGraph::DiscardModificationIfSameAsStaticGraph(const TileCoordinate tileCoord)
 {
-	return _visited[_indicesToVertices[vertexNumber]];
+	const u32 adjListIndex = _staticGraph->indicesToVertices[GetVertexNumberFromTileCoord(tileCoord)];
+	const auto* modifiedConnectedNodes = _edgeModifications.Find(adjListIndex);
+
+	const auto& staticConnectedNodes = _staticGraph->adjList[adjListIndex];
+
+	if (nullptr != modifiedConnectedNodes && modifiedConnectedNodes->cost == staticConnectedNodes.cost 
+		&& modifiedConnectedNodes->HasSameNodesAs(staticConnectedNodes)) {
+		_edgeModifications.Remove(adjListIndex);
+	}
 }
 
-void MazeGraph::MarkVertexAsVisited(const u32 vertexNumber) const
+MazeGraph::SearchScratch& MazeGraph::GetSearchScratch()
 {
-	_visited[_indicesToVertices[vertexNumber]] = true;
+	thread_local SearchScratch scratch{};
+	return scratch;
+}
+
+template<bool bHasEdgeModifications>
+MazeGraph::SearchView<bHasEdgeModifications> MazeGraph::BeginSearch() const
+{
+	SearchScratch& scratch = GetSearchScratch();
+
+	const StaticGraph& staticGraph = *_staticGraph;
+
+	//Stamps are only set for vertices visited by earlier searches, so new ones start unvisited.
+	auto& visitStamps = scratch.visitStamps;
+	const int32 numOldVisitStamps = visitStamps.Num();
+	if (numOldVisitStamps < staticGraph.adjList.Num()) {
+		visitStamps.SetNumUninitialized(staticGraph.adjList.Num(), EAllowShrinking::No);
+		memset(visitStamps.GetData() + numOldVisitStamps, 0, (visitStamps.Num() - numOldVisitStamps) * sizeof(u8));
+	}
+
+	++scratch.visitStamp;
+	if (0U == scratch.visitStamp) [[unlikely]] {
+		memset(visitStamps.GetData(), 0, visitStamps.Num() * sizeof(u8));
+		scratch.visitStamp = 1U;
+	}
+
+	SearchView<bHasEdgeModifications> searchView{};
+	searchView.adjList = staticGraph.adjList.GetData();
+	searchView.indicesToVertices = staticGraph.indicesToVertices.GetData();
+	searchView.edgeModifications = &_edgeModifications;
+	searchView.visitStamps = visitStamps.GetData();
+	searchView.visitStamp = scratch.visitStamp;
+	searchView.scratch = &scratch;
+
+	if constexpr (bHasEdgeModifications) {
+		auto& modifiedVertexFilter = scratch.modifiedVertexFilter;
+		memset(modifiedVertexFilter.GetData(), 0, sizeof(u64) * modifiedVertexFilter.Num());
+		for (const auto& modification : _edgeModifications) {
+			const u32 filterBitIndex = modification.Key & (NumModifiedVertexFilterBits - 1U);
+			modifiedVertexFilter[filterBitIndex / 64U] |= 1ULL << (filterBitIndex % 64U);
+		}
+		searchView.modifiedVertexFilter = modifiedVertexFilter.GetData();
+	}
+
+	return searchView;
 }
 
 u32 MazeGraph::FindMostAlignedTileCoordIndexAlongDirection(const ConnectedMazeNodesToSingleNode& connectedNodes
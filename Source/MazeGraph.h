@@ -6,10 +6,15 @@
 #include "Containers/StaticArray.h"
 #include "Containers/Array.h"
 #include "Containers/Queue.h"
+#include "Containers/Map.h"
+#include "Templates/SharedPointer.h"
 #include "CommonTypes.h"
+#include "MazeGraphStats.h"
 
 #include <limits>
 
+class ReservationTable;
+class PathRandomStream;
 
 /*
 * It is primarily intended to be used for tile-based games like turn-based and tiled rpgs.
@@ -17,13 +22,31 @@
 * It assumes that ONLY walkable tiles will 
 * be used as the vertices and that the graph 
 * to be constructed is undirected connected one 
-* where each tile has the same cost.
+* where each tile has the same cost unless SetTileCost() is used.
 * 
 * Vertices and all its edges can be added at once only for now.
 * This will change in the futrue where I will try adding any
 * number of adjacent edges to the graph.
 * 
 *It is not thread safe.
+* 
+* Copying a MazeGraph is cheap: the vertices and edges added through
+* Init() and AddEdge() live in a reference-counted immutable block that
+* all copies share, and every copy owns only a small overlay of edge
+* modifications (see OpenEdge() and CloseEdge()). This lets many matches played on the same map share
+* one graph while each of them opens and closes its own doors. The shared
+* block is only copied when AddEdge() is called on a graph that is still
+* shared with other copies. SetTileCost() on a shared graph stores the cost
+* in the overlay of that copy instead, so costs common to every match are 
+* best set before copying. Different copies can be used from different
+* threads at the same time.
+* 
+* The search scratch buffers do not belong to any graph. Every thread that 
+* searches keeps one set of them for all the graphs it searches, sized for the 
+* largest map it searched so far: 1 byte per vertex for the visit stamps plus 
+* 8 bytes per entry of the search tree, which holds up to 1 entry per vertex, 
+* or per edge end for searches using tile costs. They are only freed when the
+* thread exits.
 */
 
 class PACMANUE_API MazeGraph final
@@ -35,8 +58,15 @@ private:
 
 		void AddNode(const TileCoordinate nodeCoord, const u32 tilemapWidth);
 
+		void RemoveNode(const TileCoordinate nodeCoord, const u32 tilemapWidth);
+
+		[[nodiscard]] bool HasSameNodesAs(const ConnectedMazeNodesToSingleNode& other) const;
+
 		TStaticArray<u32, 4> connectedNodes{std::numeric_limits<u32>::max()};
-		u32 size{};
+		u8 size{};
+
+		//Cost of entering this vertex. Kept here so that it is read along with the adjacent vertices without taking extra space.
+		u8 cost{ 1U };
 	};
 
 	struct TraversedNode final
@@ -45,6 +75,75 @@ private:
 		u32 parentNodeIndex{ std::numeric_limits<u32>::max() };
 	};
 
+	/*
+	* Vertices and edges shared by every copy of the graph. It is never 
+	* modified while more than one MazeGraph references it.
+	*/
+	struct StaticGraph final
+	{
+		TArray<ConnectedMazeNodesToSingleNode> adjList{};
+		TArray<u32> indicesToVertices{};
+		u32 currentAdjListIndex{};
+	};
+
+	//Enough bits for a few hundred modified vertices to rarely share one.
+	static constexpr u32 NumModifiedVertexFilterBits = 4096U;
+
+	/*
+	* Buffers reused between searches by every graph searched on the same thread.
+	* See the class comment for how large they get.
+	*/
+	struct SearchScratch final
+	{
+		TArray<TraversedNode> tree{};
+		TQueue<u32> queue{};
+		TQueue<FUint32Vector2> queueWithLength{};
+		/*
+		* A vertex is visited when its stamp equals visitStamp, which changes for every 
+		* search, so starting a search does not have to clear the stamps of every vertex.
+		* 0 means not visited. They are only all cleared once every 255 searches, when 
+		* visitStamp wraps around.
+		*/
+		TArray<u8> visitStamps{};
+		u8 visitStamp{};
+
+		//Circular buckets of the weighted search, holding indices into tree. Only allocated once a weighted search happens.
+		TArray<TArray<u32>> costBuckets{};
+
+		//Vertex numbers on the part of the unconstrained path a cooperative search can reach, mapped to their index on it.
+		TMap<u32, u32> windowPathIndices{};
+
+		//Bit i is set when an overlay record exists for an adjacency list index whose lowest bits equal i. Rebuilt for every search of a modified graph.
+		TStaticArray<u64, NumModifiedVertexFilterBits / 64U> modifiedVertexFilter{};
+	};
+
+	/*
+	* Raw pointers into the shared block, the overlay and the scratch buffers of 
+	* the thread, taken once per search. The search loops read through them instead of the shared
+	* pointer and only look vertices up in the overlay when the graph has edge
+	* modifications and the filter says the vertex may have been modified.
+	*/
+	template<bool bHasEdgeModifications>
+	struct SearchView final
+	{
+		[[nodiscard]] const ConnectedMazeNodesToSingleNode& GetConnectedNodes(const u32 vertexNumber) const;
+
+		[[nodiscard]] bool VertexVisitedBefore(const u32 vertexNumber) const;
+		void MarkVertexAsVisited(const u32 vertexNumber) const;
+		void UnmarkVertexAsVisited(const u32 vertexNumber) const;
+
+		const ConnectedMazeNodesToSingleNode* adjList{};
+		const u32* indicesToVertices{};
+		const TMap<u32, ConnectedMazeNodesToSingleNode>* edgeModifications{};
+		const u64* modifiedVertexFilter{};
+		u8* visitStamps{};
+		u8 visitStamp{};
+		SearchScratch* scratch{};
+	};
+
+	//Larger than the maximum tile cost so that the circular buckets of the weighted search never wrap onto a queued cost.
+	static constexpr u32 NumCostBuckets = 256U;
+
 public:
 
 	/*
@@ -70,6 +169,56 @@ public:
 	*/
 	void AddEdge(const TileCoordinate v, const TileCoordinate w);
 
+	/*
+	* Connects 2 vertices that were already added through AddEdge() for this 
+	* copy of the graph only. Useful for opening doors without touching the 
+	* graph shared with other copies. Tiles that are not vertices yet are ignored.
+	* Nothing happens when either vertex is already connected to 4 vertices.
+	* 
+	* The passed tile coordinates do not need to be bound checked before passing them.
+	*/
+	void OpenEdge(const TileCoordinate v, const TileCoordinate w);
+
+	/*
+	* Disconnects 2 vertices for this copy of the graph only. Useful for
+	* closing doors without touching the graph shared with other copies.
+	* 
+	* The passed tile coordinates do not need to be bound checked before passing them.
+	*/
+	void CloseEdge(const TileCoordinate v, const TileCoordinate w);
+
+	/*
+	* Discards all the edges opened or closed by OpenEdge() and CloseEdge().
+	* Tile costs are kept.
+	*/
+	void ClearEdgeModifications();
+
+	/*
+	* Number of vertices whose adjacent vertices differ from the graph shared with other copies.
+	*/
+	[[nodiscard]] u32 GetTotalNumEdgeModifications() const;
+
+	/*
+	* Sets the cost of entering the given tile, for example higher for mud or 
+	* water. Every tile costs 1 by default and a cost of 0 is treated as 1. 
+	* Tiles that are not vertices yet are ignored.
+	* 
+	* While any tile costs more than 1, GenerateShortestPathFromSourceToTarget(), 
+	* GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile() and 
+	* GenerateNonTrivialRandomPathStartingFromSource() return the cheapest paths instead 
+	* of the ones with the fewest tiles. The other path generation methods ignore costs.
+	* 
+	* Like OpenEdge() and CloseEdge() it only affects this copy of the graph.
+	* 
+	* The passed tile coordinate does not need to be bound checked before passing it.
+	*/
+	void SetTileCost(const TileCoordinate tileCoord, const u8 cost);
+
+	/*
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	*/
+	[[nodiscard]] u8 GetTileCost(const TileCoordinate tileCoord) const;
+
 
 	/*
 	* Make sure to check the bounds of the given tile coordinate before passing it.
@@ -128,6 +277,101 @@ public:
 	*/
 	[[nodiscard]] TArrayTilesInline16 GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(const TileCoordinate source
 	, const TileCoordinate target, const TileCoordinate tileToAvoid) const;
+
+	/*
+	* Random walk of a length between minLength and maxLength that never steps 
+	* back onto the tile it just left unless it is at a dead end. It takes time
+	* proportional to the length only and the result depends only on the state
+	* of the given random stream, so it can be replayed.
+	* 
+	* Unlike the other path generation methods it does not use any buffers of
+	* the graph, so it can be called from multiple threads at the same time as 
+	* long as the graph is not modified and each thread uses its own random stream.
+	* 
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	* 
+	* Returned path will always have at least 1 element in it which is the source.
+	*/
+	[[nodiscard]] TArrayTilesInline16 GenerateRandomWalkFromSource(const TileCoordinate source
+		, PathRandomStream& randomStream, const u32 minLength, const u32 maxLength) const;
+
+	/*
+	* Random walk like GenerateRandomWalkFromSource() that then walks back the same 
+	* way, so the path ends on the source and can be traversed again as a patrol.
+	* Its length is even and between minLength and maxLength, both rounded up to even numbers.
+	* 
+	* Can be called from multiple threads like GenerateRandomWalkFromSource().
+	* 
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	* 
+	* Returned path will always have at least 1 element in it which is the source.
+	*/
+	[[nodiscard]] TArrayTilesInline16 GenerateRandomPatrolFromSource(const TileCoordinate source
+		, PathRandomStream& randomStream, const u32 minLength, const u32 maxLength) const;
+
+	/*
+	* Plans at most windowLength ticks of the way to the target, one tile per tick,
+	* around the tiles other agents reserved in the given table. The tile at index i 
+	* of the returned path is occupied at startTick + i and the same tile repeated
+	* means waiting on it. Moving into a tile the agent on it reserved to leave into
+	* the tile being left is avoided too, so agents never swap places.
+	* 
+	* The agent gets as far as it can along the path returned by 
+	* GenerateShortestPathFromSourceToTarget(), waiting or stepping aside 
+	* for other agents when needed. Reserve the returned path with 
+	* ReservationTable::ReservePath() using the same startTick and windowLength
+	* before planning the next agent.
+	* 
+	* Reservations of the source are taken to be the agent's own, so the source 
+	* of every agent has to be reserved with ReservationTable::ReserveForWindow() 
+	* before any agent of the window is planned. The returned paths then never
+	* collide, since the agent can always wait on its source.
+	* 
+	* startTick cannot be before the current tick of the table. The window is
+	* shortened to end at the last tick the table keeps, since reservations
+	* past it are not recorded.
+	* 
+	* Every call costs a full GenerateShortestPathFromSourceToTarget(). Use the
+	* overload taking a route to reuse it between the windows of an agent.
+	* 
+	* Make sure to check the bounds of the given tile coordinates before passing them.
+	* 
+	* Returned path will always have at least 1 element in it which is the source.
+	*/
+	[[nodiscard]] TArrayTilesInline16 GenerateCooperativePathFromSourceToTarget(const TileCoordinate source
+		, const TileCoordinate target, const ReservationTable& reservations, const u32 startTick, const u32 windowLength) const;
+
+	/*
+	* Same as above, but inOutRoute keeps the unconstrained path of the agent 
+	* between its windows. Start with an empty route for every agent. As long as 
+	* the agent is still on its route and the target has not changed, the rest 
+	* of the route is reused. Otherwise it is replaced by a new full search. 
+	* While agents mostly follow their routes, most windows then cost only the 
+	* windowed search instead of a search of the whole map.
+	* 
+	* The part of a reused route the window can reach is checked against the 
+	* current edges, so a route broken by CloseEdge() or by rebuilding the graph 
+	* with Init() is searched again once a window can reach the broken part. It is 
+	* not checked against newly opened edges or changed tile costs, so it can be 
+	* longer than the best one after those. Empty it to force a new search.
+	*/
+	[[nodiscard]] TArrayTilesInline16 GenerateCooperativePathFromSourceToTarget(const TileCoordinate source, const TileCoordinate target
+		, const ReservationTable& reservations, const u32 startTick, const u32 windowLength, TArrayTilesInline16& inOutRoute) const;
+
+	/*
+	* Statistics of all the searches done since the last Init() or ResetStats().
+	* Always empty unless MAZEGRAPH_STATS is defined as 1.
+	*/
+	[[nodiscard]] MazeGraphStatsSnapshot GetStatsSnapshot() const;
+
+	void ResetStats();
+
+	/*
+	* The sink is called at the end of every search with its measurements.
+	* Never called unless MAZEGRAPH_STATS is defined as 1.
+	*/
+	void SetQueryTraceSink(MazeGraphQueryTraceSink&& traceSink);
+
 private:
 
 	[[nodiscard]] TileCoordinate GetTileCoordFromVertexNumber(const u32 nodeNumber) const;
@@ -136,11 +380,65 @@ private:
 
 	[[nodiscard]] TileCoordinate GetRandomTileCoordinate() const;
 
-	[[nodiscard]] ConnectedMazeNodesToSingleNode& GetConnectedNodeToRequestedVertexNumber(const u32 vertexNumber);
 	[[nodiscard]] const ConnectedMazeNodesToSingleNode& GetConnectedNodeToRequestedVertexNumber(const u32 vertexNumber) const;
 
-	[[nodiscard]] bool VertexVisitedBefore(const u32 vertexNumber) const;
-	void MarkVertexAsVisited(const u32 vertexNumber) const;
+	/*
+	* The query type is what the search is recorded as in the statistics.
+	*/
+	[[nodiscard]] TArrayTilesInline16 GenerateShortestPathFromSourceToTarget(const TileCoordinate source
+		, const TileCoordinate target, const MazeGraphQueryType queryType) const;
+
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GenerateShortestPathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const TileCoordinate target, const MazeGraphQueryType queryType) const;
+
+	/*
+	* Dial's algorithm: a shortest path search over buckets indexed by the accumulated cost.
+	* The path never enters the vertex numbered nodeNumberToAvoid, which can be std::numeric_limits<u32>::max() for none.
+	*/
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GenerateCheapestPathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const TileCoordinate target, const MazeGraphQueryType queryType, const u32 nodeNumberToAvoid) const;
+
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GeneratePathWithFixedLength(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const u32 length) const;
+
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GeneratePathAlongDirection(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const FInt32Vector2 direction, const u32 maxLength) const;
+
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GeneratePathBetweenTwoTilesNotGoingThroughSpecifiedTile(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const TileCoordinate target, const TileCoordinate tileToAvoid) const;
+
+	/*
+	* Drops the part of the route before the source. Returns false when the route 
+	* does not lead from the source to the target anymore and has to be searched again.
+	*/
+	[[nodiscard]] bool TrimRouteToSource(TArrayTilesInline16& route, const TileCoordinate source, const TileCoordinate target
+		, const u32 windowLength) const;
+
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] TArrayTilesInline16 GenerateCooperativePathFromSourceToTarget(const SearchView<bHasEdgeModifications> searchView
+		, const TileCoordinate source, const TArrayTilesInline16& unconstrainedPath
+		, const ReservationTable& reservations, const u32 startTick, const u32 windowLength) const;
+
+	[[nodiscard]] StaticGraph& GetStaticGraphForWriting();
+
+	[[nodiscard]] bool IsVertexInStaticGraph(const TileCoordinate tileCoord) const;
+
+	[[nodiscard]] ConnectedMazeNodesToSingleNode& GetModifiableConnectedNodes(const TileCoordinate tileCoord);
+
+	void DiscardModificationIfSameAsStaticGraph(const TileCoordinate tileCoord);
+
+	[[nodiscard]] static SearchScratch& GetSearchScratch();
+
+	/*
+	* Starts a new search with every vertex unvisited.
+	*/
+	template<bool bHasEdgeModifications>
+	[[nodiscard]] SearchView<bHasEdgeModifications> BeginSearch() const;
 
 	[[nodiscard]] u32 FindMostAlignedTileCoordIndexAlongDirection(const ConnectedMazeNodesToSingleNode& connectedNodes
 		, const u32 parentVertexNumber,const FInt32Vector2 direction) const;
@@ -148,16 +446,21 @@ private:
 private:
 
 
-	TArray<ConnectedMazeNodesToSingleNode> _adjList{};
-	TArray<u32> _indicesToVertices{};
-	u32 _currentAdjListIndex{};
+	TSharedPtr<StaticGraph, ESPMode::ThreadSafe> _staticGraph{ MakeShared<StaticGraph, ESPMode::ThreadSafe>() };
+
+	/*
+	* Keyed by the index of the modified vertex in the adjacency list of
+	* the static graph. Holds the full set of adjacent vertices and the cost
+	* that replace the static ones for this copy only.
+	*/
+	TMap<u32, ConnectedMazeNodesToSingleNode> _edgeModifications{};
+
+	//Number of tiles costing more than 1 in this copy, counting the overlay.
+	u32 _numTilesWithCost{};
 
-	mutable TArray<TraversedNode> _tree{};
-	mutable TQueue<u32> _queue{};
-	mutable TQueue<FUint32Vector2> _queueWithLength{};
-	mutable TArray<bool> _visited{};
-	
-	TArray<bool> _defaultVisited{};
+#if MAZEGRAPH_STATS
+	mutable MazeGraphStats _stats{};
+#endif
 
 	u32 tilemapWidth{};
 	u32 tilemapHeight{};
@@ -0,0 +1,153 @@
+
+
+#include "MazeGraphStats.h"
+
+#include <limits>
+
+
+
+void MazeGraphStatsHistogram::Add(const u32 value)
+{
+	const u32 bucketIndex = (0U == value) ? 0U : FMath::Min(FMath::FloorLog2(value) + 1U, NumBuckets - 1U);
+	++_buckets[bucketIndex];
+	++_totalCount;
+}
+
+u32 MazeGraphStatsHistogram::GetBucketCount(const u32 bucketIndex) const
+{
+	check(bucketIndex < NumBuckets);
+	return _buckets[bucketIndex];
+}
+
+u32 MazeGraphStatsHistogram::GetBucketLowerBound(const u32 bucketIndex)
+{
+	check(bucketIndex < NumBuckets);
+	return (0U == bucketIndex) ? 0U : (1U << (bucketIndex - 1U));
+}
+
+u32 MazeGraphStatsHistogram::GetApproximatePercentile(const u32 percentile) const
+{
+	check(percentile <= 100U);
+
+	if (0U == _totalCount) { return 0U; }
+
+	const u64 requiredCount = FMath::Max<u64>(((u64)_totalCount * percentile + 99U) / 100U, 1U);
+	u64 accumulatedCount{};
+	for (u32 i = 0U; i < NumBuckets; ++i) {
+		accumulatedCount += _buckets[i];
+		if (requiredCount <= accumulatedCount) {
+			return GetBucketLowerBound(i);
+		}
+	}
+
+	return GetBucketLowerBound(NumBuckets - 1U);
+}
+
+u32 MazeGraphStatsHistogram::GetTotalCount() const
+{
+	return _totalCount;
+}
+
+
+
+void MazeGraphStats::Record(const MazeGraphQueryRecord& record)
+{
+	auto& queryTypeStats = _snapshot.perQueryType[(u32)record.type];
+
+	++queryTypeStats.numQueries;
+	queryTypeStats.totalNodesExpanded += record.nodesExpanded;
+	queryTypeStats.maxPeakFrontierSize = FMath::Max(queryTypeStats.maxPeakFrontierSize, record.peakFrontierSize);
+	queryTypeStats.totalWallTimeSeconds += record.wallTimeSeconds;
+
+	queryTypeStats.nodesExpanded.Add(record.nodesExpanded);
+	queryTypeStats.pathLength.Add(record.pathLength);
+	queryTypeStats.wallTimeMicroseconds.Add((u32)FMath::Min(record.wallTimeSeconds * 1000000.0, (double)std::numeric_limits<u32>::max()));
+
+	_snapshot.treeHighWaterMark = FMath::Max(_snapshot.treeHighWaterMark, record.treeSize);
+
+	/*
+	* The frontier of each search lives in a different buffer. Weighted searches always use the cost buckets
+	* whatever query they answer. Cooperative windows are left out since they have no frontier besides the tree.
+	*/
+	if (record.isWeighted) {
+		_snapshot.costBucketsHighWaterMark = FMath::Max(_snapshot.costBucketsHighWaterMark, record.peakFrontierSize);
+	}
+	else {
+		switch (record.type) {
+		case MazeGraphQueryType::ShortestPath:
+		case MazeGraphQueryType::PathAlongDirection:
+		case MazeGraphQueryType::PathNotGoingThroughTile:
+		case MazeGraphQueryType::CooperativeRoute:
+			_snapshot.queueHighWaterMark = FMath::Max(_snapshot.queueHighWaterMark, record.peakFrontierSize);
+			break;
+		case MazeGraphQueryType::PathWithFixedLength:
+			_snapshot.queueWithLengthHighWaterMark = FMath::Max(_snapshot.queueWithLengthHighWaterMark, record.peakFrontierSize);
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (_traceSink) {
+		_traceSink(record);
+	}
+}
+
+MazeGraphStats& MazeGraphStats::operator=(const MazeGraphStats&)
+{
+	Reset();
+	return *this;
+}
+
+void MazeGraphStats::Reset()
+{
+	_snapshot = MazeGraphStatsSnapshot{};
+}
+
+const MazeGraphStatsSnapshot& MazeGraphStats::GetSnapshot() const
+{
+	return _snapshot;
+}
+
+void MazeGraphStats::SetTraceSink(MazeGraphQueryTraceSink&& traceSink)
+{
+	_traceSink = std::move(traceSink);
+}
+
+
+
+MazeGraphQueryRecorder::MazeGraphQueryRecorder(MazeGraphStats& stats, const MazeGraphQueryType type, const bool isWeighted)
+	: _stats(stats)
+{
+	_record.type = type;
+	_record.isWeighted = isWeighted;
+	_startCycles = FPlatformTime::Cycles64();
+}
+
+void MazeGraphQueryRecorder::OnNodeEnqueued()
+{
+	++_currentFrontierSize;
+	_record.peakFrontierSize = FMath::Max(_record.peakFrontierSize, _currentFrontierSize);
+}
+
+void MazeGraphQueryRecorder::OnNodeExpanded()
+{
+	check(0U != _currentFrontierSize);
+	--_currentFrontierSize;
+	++_record.nodesExpanded;
+}
+
+void MazeGraphQueryRecorder::OnStaleNodeDequeued()
+{
+	check(0U != _currentFrontierSize);
+	--_currentFrontierSize;
+}
+
+void MazeGraphQueryRecorder::Finish(const int32 treeSize, const int32 pathNumTiles)
+{
+	_record.treeSize = (u32)treeSize;
+	_record.pathLength = (0 < pathNumTiles) ? (u32)(pathNumTiles - 1) : 0U;
+	_record.wallTimeSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - _startCycles);
+
+	_stats.Record(_record);
+}
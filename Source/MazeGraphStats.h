@@ -0,0 +1,182 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "Templates/Function.h"
+#include "CommonTypes.h"
+
+/*
+* Define MAZEGRAPH_STATS as 1 (for example in the Build.cs of the module) 
+* to collect statistics about the searches of MazeGraph. When it is 0 none 
+* of the counting code is compiled into the search routines and the snapshots 
+* returned by MazeGraph are always empty.
+*/
+#ifndef MAZEGRAPH_STATS
+#define MAZEGRAPH_STATS 0
+#endif
+
+#if MAZEGRAPH_STATS
+#define MAZEGRAPH_STATS_ONLY(...) __VA_ARGS__
+#else
+#define MAZEGRAPH_STATS_ONLY(...)
+#endif
+
+
+enum class MazeGraphQueryType : u8
+{
+	ShortestPath,
+	PathWithFixedLength,
+	PathAlongDirection,
+	PathNotGoingThroughTile,
+	CheapestPath,
+	CooperativePath,
+	//The full search for the route of a cooperative query when it cannot be reused.
+	CooperativeRoute,
+	Count
+};
+
+/*
+* Everything that is measured for a single search.
+*/
+struct MazeGraphQueryRecord final
+{
+	MazeGraphQueryType type{};
+	u32 nodesExpanded{};
+	u32 peakFrontierSize{};
+	u32 pathLength{};
+	u32 treeSize{};
+	double wallTimeSeconds{};
+
+	//The search used the cost buckets of the weighted search as its frontier instead of a queue.
+	bool isWeighted{};
+};
+
+/*
+* Counts values into power of 2 buckets. Bucket 0 holds zeros and
+* bucket i holds the values in [2^(i-1), 2^i). The last bucket also 
+* holds everything larger than it.
+*/
+class PACMANUE_API MazeGraphStatsHistogram final
+{
+public:
+
+	static constexpr u32 NumBuckets = 32U;
+
+	void Add(const u32 value);
+
+	[[nodiscard]] u32 GetBucketCount(const u32 bucketIndex) const;
+
+	[[nodiscard]] static u32 GetBucketLowerBound(const u32 bucketIndex);
+
+	/*
+	* Returns the lower bound of the bucket containing the given percentile (0 to 100).
+	*/
+	[[nodiscard]] u32 GetApproximatePercentile(const u32 percentile) const;
+
+	[[nodiscard]] u32 GetTotalCount() const;
+
+private:
+
+	TStaticArray<u32, NumBuckets> _buckets{};
+	u32 _totalCount{};
+};
+
+
+struct MazeGraphQueryTypeStats final
+{
+	u64 numQueries{};
+	u64 totalNodesExpanded{};
+	u32 maxPeakFrontierSize{};
+	double totalWallTimeSeconds{};
+
+	MazeGraphStatsHistogram nodesExpanded{};
+	MazeGraphStatsHistogram pathLength{};
+	MazeGraphStatsHistogram wallTimeMicroseconds{};
+};
+
+/*
+* Copy of all the statistics a MazeGraph collected since its last Init() or ResetStats().
+* High-water marks are the largest sizes the scratch buffers reached in any search. 
+* costBucketsHighWaterMark counts the entries of all the buckets of the weighted search together.
+*/
+struct MazeGraphStatsSnapshot final
+{
+	TStaticArray<MazeGraphQueryTypeStats, (u32)MazeGraphQueryType::Count> perQueryType{};
+
+	u32 treeHighWaterMark{};
+	u32 queueHighWaterMark{};
+	u32 queueWithLengthHighWaterMark{};
+	u32 costBucketsHighWaterMark{};
+};
+
+/*
+* Called once at the end of every recorded search. It is called from
+* the thread doing the search so it should be cheap.
+*/
+typedef TFunction<void(const MazeGraphQueryRecord&)> MazeGraphQueryTraceSink;
+
+
+/*
+* Accumulates the records of every search. Used internally by MazeGraph.
+* 
+* Statistics belong to the graph that did the searches, so a copy starts 
+* empty and without a trace sink, and assigning over existing statistics 
+* resets them but keeps their own trace sink.
+*/
+class PACMANUE_API MazeGraphStats final
+{
+public:
+
+	MazeGraphStats() = default;
+	MazeGraphStats(const MazeGraphStats&) {}
+	MazeGraphStats(MazeGraphStats&&) = default;
+	MazeGraphStats& operator=(const MazeGraphStats&);
+	MazeGraphStats& operator=(MazeGraphStats&&) = default;
+
+	void Record(const MazeGraphQueryRecord& record);
+
+	void Reset();
+
+	[[nodiscard]] const MazeGraphStatsSnapshot& GetSnapshot() const;
+
+	void SetTraceSink(MazeGraphQueryTraceSink&& traceSink);
+
+private:
+
+	MazeGraphStatsSnapshot _snapshot{};
+	MazeGraphQueryTraceSink _traceSink{};
+};
+
+
+/*
+* Measures a single search. Only instantiated when MAZEGRAPH_STATS is 1.
+*/
+class PACMANUE_API MazeGraphQueryRecorder final
+{
+public:
+
+	MazeGraphQueryRecorder(MazeGraphStats& stats, const MazeGraphQueryType type, const bool isWeighted = false);
+
+	void OnNodeEnqueued();
+
+	void OnNodeExpanded();
+
+	/*
+	* For entries left in the frontier by a vertex that was expanded since they were queued.
+	* They leave the frontier without counting as expanded.
+	*/
+	void OnStaleNodeDequeued();
+
+	/*
+	* pathNumTiles is the number of tiles in the returned path including the source.
+	*/
+	void Finish(const int32 treeSize, const int32 pathNumTiles);
+
+private:
+
+	MazeGraphStats& _stats;
+	MazeGraphQueryRecord _record{};
+	u64 _startCycles{};
+	u32 _currentFrontierSize{};
+};
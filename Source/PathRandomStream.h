@@ -0,0 +1,71 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CommonTypes.h"
+
+
+/*
+* Small and fast PCG32 random number generator owned by the caller.
+* 
+* Same seed and sequence always produce the same numbers, so it can be
+* used for replays. Give every agent its own stream (for example seeded
+* with the match seed and the agent id as the sequence) and they can
+* generate random paths from different threads without any locking.
+* 
+* The methods are defined here so that they get inlined into the path generation loops.
+*/
+class PACMANUE_API PathRandomStream final
+{
+public:
+
+	PathRandomStream() { Seed(0U, 0U); }
+
+	explicit PathRandomStream(const u64 seed, const u64 sequence = 0U) { Seed(seed, sequence); }
+
+	/*
+	* Streams with the same seed but different sequences produce unrelated numbers.
+	*/
+	void Seed(const u64 seed, const u64 sequence = 0U)
+	{
+		_state = 0U;
+		_increment = (sequence << 1U) | 1U;
+		(void)NextU32();
+		_state += seed;
+		(void)NextU32();
+	}
+
+	[[nodiscard]] u32 NextU32()
+	{
+		const u64 oldState = _state;
+		_state = oldState * 6364136223846793005ULL + _increment;
+
+		const u32 xorShifted = (u32)(((oldState >> 18U) ^ oldState) >> 27U);
+		const u32 rotation = (u32)(oldState >> 59U);
+		return (xorShifted >> rotation) | (xorShifted << ((0U - rotation) & 31U));
+	}
+
+	/*
+	* Uniformly distributed in [0, bound). Bound must not be 0.
+	*/
+	[[nodiscard]] u32 NextBounded(const u32 bound)
+	{
+		check(0U != bound);
+
+		//Lemire's multiply and shift, rejecting the few values that would make lower results more likely.
+		u64 product = (u64)NextU32() * bound;
+		if ((u32)product < bound) {
+			const u32 threshold = (0U - bound) % bound;
+			while ((u32)product < threshold) {
+				product = (u64)NextU32() * bound;
+			}
+		}
+
+		return (u32)(product >> 32U);
+	}
+
+private:
+
+	u64 _state{};
+	u64 _increment{};
+};
@@ -0,0 +1,123 @@
+
+
+#include "ReservationTable.h"
+
+
+
+void ReservationTable::Init(const u32 tileMapWidth, const u32 tileMapHeight, const u32 horizon, const u32 maxBitsPerTick)
+{
+	check(0U != horizon);
+
+	tilemapWidth = tileMapWidth;
+	tilemapHeight = tileMapHeight;
+
+	constexpr u32 bitsPerWord = 64U;
+
+	const u32 totalNumTiles = FMath::Max(tilemapWidth * tilemapHeight, 1U);
+	const u32 bitsPerTick = FMath::Max(FMath::Min(FMath::RoundUpToPowerOfTwo(totalNumTiles), FMath::RoundUpToPowerOfTwo(maxBitsPerTick)), bitsPerWord);
+
+	_isExact = (totalNumTiles <= bitsPerTick);
+	_hashShift = 32U - FMath::FloorLog2(bitsPerTick);
+	_horizon = FMath::RoundUpToPowerOfTwo(horizon);
+	_wordsPerTick = bitsPerTick / bitsPerWord;
+
+	_bits.SetNumUninitialized(_horizon * _wordsPerTick, EAllowShrinking::Yes);
+	_slotTicks.SetNumUninitialized(_horizon, EAllowShrinking::Yes);
+	_currentTick = 0U;
+
+	Clear();
+}
+
+void ReservationTable::Clear()
+{
+	for (auto& slotTick : _slotTicks) {
+		slotTick = std::numeric_limits<u32>::max();
+	}
+}
+
+void ReservationTable::AdvanceTick()
+{
+	++_currentTick;
+}
+
+u32 ReservationTable::GetCurrentTick() const
+{
+	return _currentTick;
+}
+
+u32 ReservationTable::GetHorizon() const
+{
+	return _horizon;
+}
+
+void ReservationTable::Reserve(const TileCoordinate tileCoord, const u32 tick)
+{
+	ReserveVertex(tileCoord.Y * tilemapWidth + tileCoord.X, tick);
+}
+
+bool ReservationTable::IsReserved(const TileCoordinate tileCoord, const u32 tick) const
+{
+	return IsVertexReserved(tileCoord.Y * tilemapWidth + tileCoord.X, tick);
+}
+
+void ReservationTable::ReservePath(const TArrayTilesInline16& path, const u32 startTick, const u32 windowLength)
+{
+	check(0 != path.Num());
+
+	for (int32 i = 0; i < path.Num(); ++i) {
+		Reserve(path[i], startTick + (u32)i);
+	}
+
+	const auto lastTile = path[path.Num() - 1];
+	for (u32 i = (u32)path.Num(); i <= windowLength; ++i) {
+		Reserve(lastTile, startTick + i);
+	}
+}
+
+void ReservationTable::ReserveForWindow(const TileCoordinate tileCoord, const u32 startTick, const u32 windowLength)
+{
+	for (u32 i = 0U; i <= windowLength; ++i) {
+		Reserve(tileCoord, startTick + i);
+	}
+}
+
+bool ReservationTable::IsVertexReserved(const u32 vertexNumber, const u32 tick) const
+{
+	const u32 slot = tick & (_horizon - 1U);
+	if (false == IsTickKept(tick) || tick != _slotTicks[slot]) { return false; }
+
+	const u32 bitIndex = GetBitIndex(vertexNumber);
+	return 0U != (_bits[slot * _wordsPerTick + bitIndex / 64U] & (1ULL << (bitIndex % 64U)));
+}
+
+void ReservationTable::ReserveVertex(const u32 vertexNumber, const u32 tick)
+{
+	if (false == IsTickKept(tick)) { return; }
+
+	const u32 slot = tick & (_horizon - 1U);
+	u64* slotBits = _bits.GetData() + slot * _wordsPerTick;
+
+	//The slot still holds an older tick that is not kept anymore.
+	if (tick != _slotTicks[slot]) {
+		memset(slotBits, 0, _wordsPerTick * sizeof(u64));
+		_slotTicks[slot] = tick;
+	}
+
+	const u32 bitIndex = GetBitIndex(vertexNumber);
+	slotBits[bitIndex / 64U] |= (1ULL << (bitIndex % 64U));
+}
+
+u32 ReservationTable::GetBitIndex(const u32 vertexNumber) const
+{
+	if (_isExact) [[likely]] {
+		return vertexNumber;
+	}
+
+	//Fibonacci hashing keeps the top bits of the product, which mix all the bits of the vertex number.
+	return (vertexNumber * 2654435769U) >> _hashShift;
+}
+
+bool ReservationTable::IsTickKept(const u32 tick) const
+{
+	return (tick - _currentTick) < _horizon;
+}
@@ -0,0 +1,105 @@
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Array.h"
+#include "CommonTypes.h"
+
+#include <limits>
+
+
+/*
+* Records which tiles are taken at which ticks so that agents planning
+* one after another with MazeGraph::GenerateCooperativePathFromSourceToTarget()
+* can avoid each other. Only a bounded number of ticks starting at the current 
+* one is kept; reservations outside of it are ignored.
+* 
+* Every tick has its own bitset indexed by the tile. When the map has more tiles
+* than the bitset of a tick has bits the tiles are hashed into it, so a tile can 
+* be reported as reserved while it is not. This can only make agents wait or take 
+* detours more often, never collide.
+* 
+* Typical use is clearing the table at the start of each planning window,
+* reserving the current tile of every agent for the whole window with 
+* ReserveForWindow() and then planning and reserving the path of each agent 
+* in order of priority. Every agent can then always wait on its own tile, 
+* so the planned paths never collide. The price is that agents planned 
+* earlier cannot walk through the tiles agents planned later start the window on.
+* 
+* It is not thread safe.
+*/
+class PACMANUE_API ReservationTable final
+{
+public:
+
+	/*
+	* Horizon is the number of ticks kept, rounded up to a power of 2.
+	* maxBitsPerTick bounds the memory used for each tick. When it is not
+	* smaller than the number of tiles the table is exact.
+	*/
+	void Init(const u32 tileMapWidth, const u32 tileMapHeight, const u32 horizon = 32U, const u32 maxBitsPerTick = 1U << 16U);
+
+	/*
+	* Removes all the reservations without changing the current tick.
+	*/
+	void Clear();
+
+	/*
+	* Moves the kept ticks 1 tick forward and drops the reservations of the current tick.
+	*/
+	void AdvanceTick();
+
+	[[nodiscard]] u32 GetCurrentTick() const;
+
+	[[nodiscard]] u32 GetHorizon() const;
+
+	/*
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	*/
+	void Reserve(const TileCoordinate tileCoord, const u32 tick);
+
+	/*
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	*/
+	[[nodiscard]] bool IsReserved(const TileCoordinate tileCoord, const u32 tick) const;
+
+	/*
+	* Reserves the i-th tile of the path at startTick + i and keeps the last 
+	* tile reserved until startTick + windowLength, where the agent waits 
+	* for its next plan.
+	*/
+	void ReservePath(const TArrayTilesInline16& path, const u32 startTick, const u32 windowLength);
+
+	/*
+	* Reserves the tile at every tick from startTick to startTick + windowLength.
+	* 
+	* Make sure to check the bounds of the given tile coordinate before passing it.
+	*/
+	void ReserveForWindow(const TileCoordinate tileCoord, const u32 startTick, const u32 windowLength);
+
+private:
+
+	friend class MazeGraph;
+
+	[[nodiscard]] bool IsVertexReserved(const u32 vertexNumber, const u32 tick) const;
+
+	void ReserveVertex(const u32 vertexNumber, const u32 tick);
+
+	[[nodiscard]] u32 GetBitIndex(const u32 vertexNumber) const;
+
+	[[nodiscard]] bool IsTickKept(const u32 tick) const;
+
+private:
+
+	TArray<u64> _bits{};
+	TArray<u32> _slotTicks{};
+
+	u32 _currentTick{};
+	u32 _horizon{};
+	u32 _wordsPerTick{};
+	u32 _hashShift{};
+	bool _isExact{};
+
+	u32 tilemapWidth{};
+	u32 tilemapHeight{};
+};